@@ -0,0 +1,409 @@
+#include "analyzer.h"
+#include <stdio.h>    // Para entrada e saída padrão
+#include <stdlib.h>   // Para funções de alocação de memória
+#include <string.h>   // Para manipulação de strings
+#include <mpi.h>      // Para juntar os resultados entre processos
+#include "count_exchange.h"  // Para a redução particionada por hash
+#include "tokenizer.h"       // Para separar as palavras das letras
+
+// Cria um contador de palavras vazio
+WordCounter* word_counter_create(int approximate) {
+    WordCounter *counter = malloc(sizeof(WordCounter));
+    counter->table = approximate ? NULL : count_table_create(WORD_TABLE_INITIAL_KEYS);
+    counter->sketch = approximate ? sketch_create() : NULL;
+    return counter;
+}
+
+// Libera a memória do contador de palavras
+void word_counter_free(WordCounter *counter) {
+    if (counter) {
+        count_table_free(counter->table);
+        sketch_free(counter->sketch);
+        free(counter);
+    }
+}
+
+// Conta uma palavra entregue pelo tokenizador
+static void word_counter_add_word(void *context, const char *word, int len) {
+    // Busca O(1) na tabela hash (palavras novas são internadas na arena da tabela)
+    count_table_add((CountTable*)context, word, len, 1);
+}
+
+// Registra uma palavra no sketch (modo aproximado)
+static void word_counter_sketch_word(void *context, const char *word, int len) {
+    sketch_add((Sketch*)context, word, len, 1);
+}
+
+// Processa as palavras da letra de uma música
+static void word_counter_process_song(void *state, const SongView *song, int song_index) {
+    (void)song_index;  // A posição da música não importa para a contagem
+    WordCounter *counter = (WordCounter*)state;
+
+    // As letras são classificadas 32 bytes por vez (AVX2/SSE4.2, com versão escalar), e as
+    // palavras de 2 a 50 letras já chegam em minúsculas
+    if (counter->sketch) {
+        tokenize_words(song->text, song->text_len, word_counter_sketch_word, counter->sketch);
+    } else {
+        tokenize_words(song->text, song->text_len, word_counter_add_word, counter->table);
+    }
+}
+
+// Cria um contador vazio para uma thread
+static void* word_counter_clone(void *state) {
+    return word_counter_create(((WordCounter*)state)->sketch != NULL);
+}
+
+// Soma o contador de uma thread no principal
+static void word_counter_merge(void *state, void *local) {
+    WordCounter *counter = (WordCounter*)state;
+    if (counter->sketch) {
+        sketch_merge(counter->sketch, ((WordCounter*)local)->sketch);
+    } else {
+        count_table_merge(counter->table, ((WordCounter*)local)->table);
+    }
+    word_counter_free((WordCounter*)local);
+}
+
+// Monta o analisador que alimenta o contador de palavras
+Analyzer word_counter_analyzer(WordCounter *counter) {
+    Analyzer analyzer = { "words", counter, word_counter_process_song, word_counter_clone, word_counter_merge };
+    return analyzer;
+}
+
+// Seleciona o top-K da tabela (heap de tamanho K, sem ordenar a tabela inteira)
+static void export_words(const CountTable *table, WordCount **result) {
+    WordCount *out = (WordCount*)calloc(TOP_K, sizeof(WordCount));
+    size_t top[TOP_K];
+    size_t n = count_table_top_k(table, TOP_K, top);
+    for (size_t i = 0; i < n; i++) {
+        const CountSlot *slot = &table->slots[top[i]];
+        strcpy(out[i].word, count_table_key(table, slot));
+        out[i].count = slot->count;
+    }
+    *result = out;
+}
+
+// Junta as contagens de todos os processos no processo 0
+void word_counter_reduce(WordCounter *counter, ReduceMode mode, WordCount **word_counts, int *num_words, SketchBounds *bounds, int world_rank) {
+    if (mode == REDUCE_SKETCH) {
+        CountTable* top = sketch_reduce(counter->sketch, TOP_K, bounds, 0, MPI_COMM_WORLD);
+        if (world_rank == 0) {
+            export_words(top, word_counts);
+            *num_words = (int)(bounds->distinct + 0.5);
+            count_table_free(top);
+        }
+    } else if (mode == REDUCE_SHUFFLE) {
+        // Cada processo reduz só a sua faixa de hashes; o processo 0 recebe apenas o top-K de cada dono
+        long long total_words = 0;
+        CountTable* top = count_exchange_shuffle(counter->table, TOP_K, &total_words, 0, MPI_COMM_WORLD);
+        if (world_rank == 0) {
+            export_words(top, word_counts);
+            *num_words = (int)total_words;
+            count_table_free(top);
+        }
+    } else if (mode == REDUCE_TPUT) {
+        // Rodadas com limiar: só saem de cada processo as chaves que ainda podem chegar ao top-K
+        CountTable* candidates = count_exchange_tput(counter->table, TOP_K, 0, MPI_COMM_WORLD);
+        if (world_rank == 0) {
+            export_words(candidates, word_counts);
+            *num_words = -1;  // O número de chaves distintas não é calculado neste modo
+            count_table_free(candidates);
+        }
+    } else {
+        // Cada processo envia a tabela compactada; o processo 0 a soma na própria tabela hash
+        count_exchange_gather(counter->table, 0, MPI_COMM_WORLD);
+        if (world_rank == 0) {
+            export_words(counter->table, word_counts);
+            *num_words = (int)counter->table->size;
+        }
+    }
+
+    if (world_rank == 0) {
+        if (mode == REDUCE_SKETCH) {
+            printf(": Word counting completed. Found ~%d unique words (HyperLogLog, ±%.1f%%).\n",
+                   *num_words, bounds->distinct_error * 100.0);
+        } else if (*num_words >= 0) {
+            printf(": Word counting completed. Found %d unique words.\n", *num_words);
+        } else {
+            printf(": Word counting completed.\n");
+        }
+        printf("Top 10 most frequent words:\n");
+        for (int i = 0; i < TOP_K && (*word_counts)[i].count > 0; i++) {
+            printf("  %d. %s: %d occurrences\n", i + 1, (*word_counts)[i].word, (*word_counts)[i].count);
+        }
+    }
+}
+
+// Palavras contadas por este processo
+long long word_counter_tokens(const WordCounter *counter) {
+    return counter->sketch ? (long long)counter->sketch->total : count_table_total(counter->table);
+}
+
+// Palavras distintas deste processo
+long long word_counter_keys(const WordCounter *counter) {
+    return counter->sketch ? (long long)sketch_distinct(counter->sketch) : (long long)counter->table->size;
+}
+
+// Cria um contador de artistas vazio
+ArtistCounter* artist_counter_create(int approximate) {
+    ArtistCounter *counter = malloc(sizeof(ArtistCounter));
+    counter->table = approximate ? NULL : count_table_create(ARTIST_TABLE_INITIAL_KEYS);
+    counter->sketch = approximate ? sketch_create() : NULL;
+    return counter;
+}
+
+// Libera a memória do contador de artistas
+void artist_counter_free(ArtistCounter *counter) {
+    if (counter) {
+        count_table_free(counter->table);
+        sketch_free(counter->sketch);
+        free(counter);
+    }
+}
+
+// Conta a música para o seu artista
+static void artist_counter_process_song(void *state, const SongView *song, int song_index) {
+    (void)song_index;  // A posição da música não importa para a contagem
+    ArtistCounter *counter = (ArtistCounter*)state;
+
+    // O nome emprestado é buscado no lugar, sem cópia (mesmo limite de tamanho de antes)
+    int artist_len = (song->artist_len < MAX_ARTIST_LENGTH - 1) ? song->artist_len : MAX_ARTIST_LENGTH - 1;
+    if (counter->sketch) {
+        sketch_add(counter->sketch, song->artist, artist_len, 1);
+    } else {
+        count_table_add(counter->table, song->artist, artist_len, 1);
+    }
+}
+
+// Cria um contador vazio para uma thread
+static void* artist_counter_clone(void *state) {
+    return artist_counter_create(((ArtistCounter*)state)->sketch != NULL);
+}
+
+// Soma o contador de uma thread no principal
+static void artist_counter_merge(void *state, void *local) {
+    ArtistCounter *counter = (ArtistCounter*)state;
+    if (counter->sketch) {
+        sketch_merge(counter->sketch, ((ArtistCounter*)local)->sketch);
+    } else {
+        count_table_merge(counter->table, ((ArtistCounter*)local)->table);
+    }
+    artist_counter_free((ArtistCounter*)local);
+}
+
+// Monta o analisador que alimenta o contador de artistas
+Analyzer artist_counter_analyzer(ArtistCounter *counter) {
+    Analyzer analyzer = { "artists", counter, artist_counter_process_song, artist_counter_clone, artist_counter_merge };
+    return analyzer;
+}
+
+// Seleciona o top-K da tabela (heap de tamanho K, sem ordenar a tabela inteira)
+static void export_artists(const CountTable *table, ArtistCount **result) {
+    ArtistCount *out = (ArtistCount*)calloc(TOP_K, sizeof(ArtistCount));
+    size_t top[TOP_K];
+    size_t n = count_table_top_k(table, TOP_K, top);
+    for (size_t i = 0; i < n; i++) {
+        const CountSlot *slot = &table->slots[top[i]];
+        strcpy(out[i].artist, count_table_key(table, slot));
+        out[i].song_count = slot->count;
+    }
+    *result = out;
+}
+
+// Junta as contagens de todos os processos no processo 0
+void artist_counter_reduce(ArtistCounter *counter, ReduceMode mode, ArtistCount **artist_counts, int *num_artists, SketchBounds *bounds, int world_rank) {
+    if (mode == REDUCE_SKETCH) {
+        CountTable* top = sketch_reduce(counter->sketch, TOP_K, bounds, 0, MPI_COMM_WORLD);
+        if (world_rank == 0) {
+            export_artists(top, artist_counts);
+            *num_artists = (int)(bounds->distinct + 0.5);
+            count_table_free(top);
+        }
+    } else if (mode == REDUCE_SHUFFLE) {
+        // Cada processo reduz só a sua faixa de hashes; o processo 0 recebe apenas o top-K de cada dono
+        long long total_artists = 0;
+        CountTable* top = count_exchange_shuffle(counter->table, TOP_K, &total_artists, 0, MPI_COMM_WORLD);
+        if (world_rank == 0) {
+            export_artists(top, artist_counts);
+            *num_artists = (int)total_artists;
+            count_table_free(top);
+        }
+    } else if (mode == REDUCE_TPUT) {
+        // Rodadas com limiar: só saem de cada processo as chaves que ainda podem chegar ao top-K
+        CountTable* candidates = count_exchange_tput(counter->table, TOP_K, 0, MPI_COMM_WORLD);
+        if (world_rank == 0) {
+            export_artists(candidates, artist_counts);
+            *num_artists = -1;  // O número de chaves distintas não é calculado neste modo
+            count_table_free(candidates);
+        }
+    } else {
+        // Cada processo envia a tabela compactada; o processo 0 a soma na própria tabela hash
+        count_exchange_gather(counter->table, 0, MPI_COMM_WORLD);
+        if (world_rank == 0) {
+            export_artists(counter->table, artist_counts);
+            *num_artists = (int)counter->table->size;
+        }
+    }
+
+    if (world_rank == 0) {
+        if (mode == REDUCE_SKETCH) {
+            printf(": Artist counting completed. Found ~%d unique artists (HyperLogLog, ±%.1f%%).\n",
+                   *num_artists, bounds->distinct_error * 100.0);
+        } else if (*num_artists >= 0) {
+            printf(": Artist counting completed. Found %d unique artists.\n", *num_artists);
+        } else {
+            printf(": Artist counting completed.\n");
+        }
+        printf("Top 10 artists with most songs:\n");
+        for (int i = 0; i < TOP_K && (*artist_counts)[i].song_count > 0; i++) {
+            printf("  %d. %s: %d songs\n", i + 1, (*artist_counts)[i].artist, (*artist_counts)[i].song_count);
+        }
+    }
+}
+
+// Artistas distintos deste processo
+long long artist_counter_keys(const ArtistCounter *counter) {
+    return counter->sketch ? (long long)sketch_distinct(counter->sketch) : (long long)counter->table->size;
+}
+
+// Cria o seletor de músicas para o LLM
+LlmSelector* llm_selector_create(int limit) {
+    LlmSelector *selector = malloc(sizeof(LlmSelector));
+    selector->limit = limit;
+    selector->count = 0;
+    selector->capacity = 0;
+    selector->indices = NULL;
+    selector->lyrics = NULL;
+    return selector;
+}
+
+// Libera a memória do seletor e das letras copiadas
+void llm_selector_free(LlmSelector *selector) {
+    if (selector) {
+        for (int i = 0; i < selector->count; i++) {
+            free(selector->lyrics[i]);
+        }
+        free(selector->indices);
+        free(selector->lyrics);
+        free(selector);
+    }
+}
+
+// Guarda uma cópia da letra, aumentando os vetores quando necessário
+static void llm_selector_add(LlmSelector *selector, int song_index, const char *text, int text_len) {
+    if (selector->count == selector->capacity) {
+        selector->capacity = selector->capacity ? selector->capacity * 2 : 16;
+        selector->indices = realloc(selector->indices, selector->capacity * sizeof(int));
+        selector->lyrics = realloc(selector->lyrics, selector->capacity * sizeof(char*));
+    }
+    selector->indices[selector->count] = song_index;
+    selector->lyrics[selector->count] = strndup(text, text_len);
+    selector->count++;
+}
+
+// Seleciona a música se ela estiver entre as primeiras 'limit' linhas
+static void llm_selector_process_song(void *state, const SongView *song, int song_index) {
+    LlmSelector *selector = (LlmSelector*)state;
+    if (song_index < selector->limit) {
+        llm_selector_add(selector, song_index, song->text, song->text_len);
+    }
+}
+
+// Cria um seletor vazio, com o mesmo limite, para uma thread
+static void* llm_selector_clone(void *state) {
+    return llm_selector_create(((LlmSelector*)state)->limit);
+}
+
+// Move as músicas escolhidas por uma thread para o seletor principal
+static void llm_selector_merge(void *state, void *local) {
+    LlmSelector *selector = (LlmSelector*)state;
+    LlmSelector *other = (LlmSelector*)local;
+    for (int i = 0; i < other->count; i++) {
+        llm_selector_add(selector, other->indices[i], other->lyrics[i], strlen(other->lyrics[i]));
+    }
+    llm_selector_free(other);
+}
+
+// Monta o analisador que alimenta o seletor de músicas do LLM
+Analyzer llm_selector_analyzer(LlmSelector *selector) {
+    Analyzer analyzer = { "llm-selector", selector, llm_selector_process_song, llm_selector_clone, llm_selector_merge };
+    return analyzer;
+}
+
+// Redistribui as músicas selecionadas: a música de índice i fica com o processo i % world_size
+void llm_selector_distribute(LlmSelector *selector, int world_rank, int world_size) {
+    (void)world_rank; // Suppress unused parameter warning
+    
+    // Empacota as músicas locais como [índice][tamanho][bytes da letra], agrupadas por destino
+    int *send_counts = calloc(world_size, sizeof(int));
+    int *send_displs = malloc(world_size * sizeof(int));
+    int *recv_counts = malloc(world_size * sizeof(int));
+    int *recv_displs = malloc(world_size * sizeof(int));
+    for (int i = 0; i < selector->count; i++) {
+        send_counts[selector->indices[i] % world_size] += 2 * sizeof(int) + strlen(selector->lyrics[i]);
+    }
+    int send_total = 0;
+    for (int proc = 0; proc < world_size; proc++) {
+        send_displs[proc] = send_total;
+        send_total += send_counts[proc];
+    }
+    char *packed = malloc(send_total > 0 ? send_total : 1);
+    int *fill = calloc(world_size, sizeof(int));
+    for (int i = 0; i < selector->count; i++) {
+        int dest = selector->indices[i] % world_size;
+        int len = strlen(selector->lyrics[i]);
+        char *p = packed + send_displs[dest] + fill[dest];
+        memcpy(p, &selector->indices[i], sizeof(int));
+        memcpy(p + sizeof(int), &len, sizeof(int));
+        memcpy(p + 2 * sizeof(int), selector->lyrics[i], len);
+        fill[dest] += 2 * sizeof(int) + len;
+    }
+    free(fill);
+    
+    // Cada processo descobre quanto vai receber de cada um e troca os pacotes
+    MPI_Alltoall(send_counts, 1, MPI_INT, recv_counts, 1, MPI_INT, MPI_COMM_WORLD);
+    int recv_total = 0;
+    for (int proc = 0; proc < world_size; proc++) {
+        recv_displs[proc] = recv_total;
+        recv_total += recv_counts[proc];
+    }
+    char *all = malloc(recv_total > 0 ? recv_total : 1);
+    MPI_Alltoallv(packed, send_counts, send_displs, MPI_BYTE,
+                  all, recv_counts, recv_displs, MPI_BYTE, MPI_COMM_WORLD);
+    free(packed);
+    
+    // Reconstrói a lista só com as músicas deste processo
+    for (int i = 0; i < selector->count; i++) {
+        free(selector->lyrics[i]);
+    }
+    selector->count = 0;
+    
+    char *p = all;
+    while (p < all + recv_total) {
+        int song_index, len;
+        memcpy(&song_index, p, sizeof(int));
+        memcpy(&len, p + sizeof(int), sizeof(int));
+        llm_selector_add(selector, song_index, p + 2 * sizeof(int), len);
+        p += 2 * sizeof(int) + len;
+    }
+    
+    // Ordena por índice global (inserção: a lista é pequena e quase ordenada)
+    for (int i = 1; i < selector->count; i++) {
+        int idx = selector->indices[i];
+        char *lyr = selector->lyrics[i];
+        int j = i - 1;
+        while (j >= 0 && selector->indices[j] > idx) {
+            selector->indices[j + 1] = selector->indices[j];
+            selector->lyrics[j + 1] = selector->lyrics[j];
+            j--;
+        }
+        selector->indices[j + 1] = idx;
+        selector->lyrics[j + 1] = lyr;
+    }
+    
+    free(send_counts);
+    free(send_displs);
+    free(recv_counts);
+    free(recv_displs);
+    free(all);
+}
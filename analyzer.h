@@ -0,0 +1,186 @@
+#ifndef ANALYZER_H
+#define ANALYZER_H
+
+// Inclusão das bibliotecas necessárias
+#include "song_source.h"  // Para SongView
+#include "count_table.h"  // Para a tabela de contagem com chaves internadas
+#include "sketch.h"       // Para a contagem aproximada com memória fixa
+
+// Definições de constantes para limites das tabelas de contagem
+#define MAX_WORD_LENGTH 100      // Tamanho máximo de uma palavra
+#define MAX_ARTIST_LENGTH 200    // Tamanho máximo do nome do artista
+#define WORD_TABLE_INITIAL_KEYS 4096    // Estimativa inicial de palavras únicas (a tabela cresce)
+#define ARTIST_TABLE_INITIAL_KEYS 256   // Estimativa inicial de artistas únicos (a tabela cresce)
+#define TOP_K 10                 // Número de palavras/artistas mostrados no resultado
+
+// Estratégia de redução das contagens entre processos
+typedef enum {
+    REDUCE_GATHER,   // Todos enviam a tabela inteira ao processo 0, que junta em série
+    REDUCE_SHUFFLE,  // Chaves particionadas por hash entre os processos (MPI_Alltoallv)
+    REDUCE_TPUT,     // Top-K exato em três fases com limiar, sem enviar as tabelas inteiras
+    REDUCE_SKETCH    // Contagem aproximada: sketches de tamanho fixo somados com MPI_Reduce
+} ReduceMode;
+
+// Estrutura para armazenar contagem de palavras
+typedef struct {
+    char word[MAX_WORD_LENGTH];  // A palavra em si
+    int count;                   // Quantas vezes a palavra aparece
+} WordCount;
+
+// Estrutura para armazenar contagem de artistas
+typedef struct {
+    char artist[MAX_ARTIST_LENGTH];  // Nome do artista
+    int song_count;                  // Quantas músicas o artista tem
+} ArtistCount;
+
+// Analisador plugável: recebe cada música lida na passada sobre o CSV.
+// Novos analisadores só precisam fornecer o estado e a função de processamento;
+// clone_state e merge_state permitem que threads trabalhem em cópias locais do estado.
+typedef struct {
+    const char *name;  // Nome usado nos logs
+    void *state;       // Estado próprio do analisador (WordCounter, ArtistCounter, ...)
+    void (*process_song)(void *state, const SongView *song, int song_index);  // Chamado para cada música
+    void* (*clone_state)(void *state);             // Cria um estado vazio do mesmo tipo (para uma thread)
+    void (*merge_state)(void *state, void *local); // Soma um estado local no principal e libera o local
+} Analyzer;
+
+// Contador local de palavras de um processo (tabela exata ou sketch, nunca os dois)
+typedef struct {
+    CountTable *table;  // Palavras encontradas por este processo (NULL no modo aproximado)
+    Sketch *sketch;     // Modo aproximado: Count-Min + candidatos + HyperLogLog (NULL no exato)
+} WordCounter;
+
+// Contador local de artistas de um processo (tabela exata ou sketch, nunca os dois)
+typedef struct {
+    CountTable *table;  // Artistas encontrados por este processo (NULL no modo aproximado)
+    Sketch *sketch;     // Modo aproximado: Count-Min + candidatos + HyperLogLog (NULL no exato)
+} ArtistCounter;
+
+// Seletor das músicas enviadas ao LLM (as primeiras 'limit' linhas do CSV)
+typedef struct {
+    int limit;       // Índice global máximo (exclusivo) das músicas selecionadas
+    int count;       // Número de músicas selecionadas neste processo
+    int capacity;    // Capacidade dos vetores abaixo
+    int *indices;    // Índice global de cada música selecionada
+    char **lyrics;   // Cópia terminada em '\0' da letra de cada música
+} LlmSelector;
+
+// Declarações das funções
+
+/**
+ * Cria um contador de palavras vazio
+ * @param approximate 1 = sketch de memória fixa (REDUCE_SKETCH), 0 = tabela exata
+ * @return Ponteiro para WordCounter alocado
+ */
+WordCounter* word_counter_create(int approximate);
+
+/**
+ * Libera a memória do contador de palavras
+ * @param counter Ponteiro para WordCounter a ser liberado
+ */
+void word_counter_free(WordCounter *counter);
+
+/**
+ * Monta o analisador que alimenta o contador de palavras
+ * @param counter Contador a ser alimentado
+ * @return Analisador pronto para a passada sobre o CSV
+ */
+Analyzer word_counter_analyzer(WordCounter *counter);
+
+/**
+ * Junta as contagens de todos os processos no processo 0, seleciona e imprime o top 10
+ * @param counter Contador local deste processo
+ * @param mode Estratégia de redução entre processos
+ * @param word_counts Saída no processo 0: vetor alocado com TOP_K posições, ordenado por
+ *                    contagem (posições sem palavra ficam com contagem 0); NULL nos demais
+ * @param num_words Número total de palavras únicas (-1 no modo REDUCE_TPUT, que não o calcula;
+ *                  estimativa do HyperLogLog no modo REDUCE_SKETCH)
+ * @param bounds Saída no processo 0 no modo REDUCE_SKETCH: limites de erro das estimativas
+ * @param world_rank ID do processo atual
+ */
+void word_counter_reduce(WordCounter *counter, ReduceMode mode, WordCount **word_counts, int *num_words, SketchBounds *bounds, int world_rank);
+
+/**
+ * Total de palavras contadas por este processo (para a instrumentação)
+ * @param counter Contador local
+ * @return Número de palavras
+ */
+long long word_counter_tokens(const WordCounter *counter);
+
+/**
+ * Palavras distintas deste processo (estimativa do HyperLogLog no modo aproximado)
+ * @param counter Contador local
+ * @return Número de palavras distintas
+ */
+long long word_counter_keys(const WordCounter *counter);
+
+/**
+ * Cria um contador de artistas vazio
+ * @param approximate 1 = sketch de memória fixa (REDUCE_SKETCH), 0 = tabela exata
+ * @return Ponteiro para ArtistCounter alocado
+ */
+ArtistCounter* artist_counter_create(int approximate);
+
+/**
+ * Libera a memória do contador de artistas
+ * @param counter Ponteiro para ArtistCounter a ser liberado
+ */
+void artist_counter_free(ArtistCounter *counter);
+
+/**
+ * Monta o analisador que alimenta o contador de artistas
+ * @param counter Contador a ser alimentado
+ * @return Analisador pronto para a passada sobre o CSV
+ */
+Analyzer artist_counter_analyzer(ArtistCounter *counter);
+
+/**
+ * Junta as contagens de todos os processos no processo 0, seleciona e imprime o top 10
+ * @param counter Contador local deste processo
+ * @param mode Estratégia de redução entre processos
+ * @param artist_counts Saída no processo 0: vetor alocado com TOP_K posições, ordenado por
+ *                      contagem (posições sem artista ficam com contagem 0); NULL nos demais
+ * @param num_artists Número total de artistas únicos (-1 no modo REDUCE_TPUT, que não o calcula;
+ *                    estimativa do HyperLogLog no modo REDUCE_SKETCH)
+ * @param bounds Saída no processo 0 no modo REDUCE_SKETCH: limites de erro das estimativas
+ * @param world_rank ID do processo atual
+ */
+void artist_counter_reduce(ArtistCounter *counter, ReduceMode mode, ArtistCount **artist_counts, int *num_artists, SketchBounds *bounds, int world_rank);
+
+/**
+ * Artistas distintos deste processo (estimativa do HyperLogLog no modo aproximado)
+ * @param counter Contador local
+ * @return Número de artistas distintos
+ */
+long long artist_counter_keys(const ArtistCounter *counter);
+
+/**
+ * Cria o seletor de músicas para o LLM
+ * @param limit Seleciona as músicas com índice global menor que este valor
+ * @return Ponteiro para LlmSelector alocado
+ */
+LlmSelector* llm_selector_create(int limit);
+
+/**
+ * Libera a memória do seletor e das letras copiadas
+ * @param selector Ponteiro para LlmSelector a ser liberado
+ */
+void llm_selector_free(LlmSelector *selector);
+
+/**
+ * Monta o analisador que alimenta o seletor de músicas do LLM
+ * @param selector Seletor a ser alimentado
+ * @return Analisador pronto para a passada sobre o CSV
+ */
+Analyzer llm_selector_analyzer(LlmSelector *selector);
+
+/**
+ * Redistribui as músicas selecionadas entre os processos para dividir a classificação:
+ * a música de índice global i fica com o processo i % world_size, em ordem de índice
+ * @param selector Seletor local (passa a conter apenas as músicas deste processo)
+ * @param world_rank ID do processo atual
+ * @param world_size Número total de processos
+ */
+void llm_selector_distribute(LlmSelector *selector, int world_rank, int world_size);
+
+#endif // ANALYZER_H
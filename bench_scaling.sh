@@ -0,0 +1,113 @@
+#!/bin/bash
+
+# ========================================
+# CONFIGURAÇÕES DO BENCHMARK DE ESCALABILIDADE
+# ========================================
+# Todas podem ser trocadas pelo ambiente, ex.: RANKS="1 2 4" make bench
+RANKS=${RANKS:-"1 2 4 8"}                        # Números de processos MPI testados
+STRONG_SONGS=${STRONG_SONGS:-200000}             # Escalabilidade forte: músicas fixas
+WEAK_SONGS_PER_RANK=${WEAK_SONGS_PER_RANK:-25000} # Escalabilidade fraca: músicas por processo
+VOCAB=${VOCAB:-50000}                            # Palavras distintas do gerador
+ZIPF=${ZIPF:-1.1}                                # Expoente de Zipf das palavras
+MEAN_WORDS=${MEAN_WORDS:-220}                    # Média de palavras por letra
+LENGTH_SIGMA=${LENGTH_SIGMA:-0.5}                # Desvio (log-normal) do tamanho das letras
+SEED=${SEED:-42}                                 # Semente do gerador
+MAIN_ARGS=${MAIN_ARGS:-"--mmap --fused"}         # Opções do main em todas as execuções
+MPIRUN_ARGS=${MPIRUN_ARGS:-"--oversubscribe"}    # Opções extras do mpirun
+STUB_PORT=${STUB_PORT:-11435}                    # Porta do servidor falso do Ollama
+STUB_DELAY_MS=${STUB_DELAY_MS:-20}               # Atraso de cada resposta do servidor falso
+OUTPUT=${OUTPUT:-bench_results.json}             # Resultado (JSON)
+WORK_DIR=${WORK_DIR:-bench_data}                 # CSVs sintéticos gerados
+# ========================================
+
+echo "📈 BENCHMARK: Escalabilidade forte e fraca"
+echo "=========================================="
+echo "- Processos: $RANKS"
+echo "- Forte: $STRONG_SONGS músicas | Fraca: $WEAK_SONGS_PER_RANK músicas por processo"
+echo "- Vocabulário: $VOCAB palavras, zipf $ZIPF, média de $MEAN_WORDS palavras por letra"
+echo "- Opções: $MAIN_ARGS"
+echo ""
+
+if [ ! -x ./main ] || [ ! -x ./synth_lyrics ]; then
+    echo "❌ Compile antes com: make main synth_lyrics (ou use make bench)"
+    exit 1
+fi
+
+mkdir -p "$WORK_DIR"
+
+# Gera (uma vez por combinação de parâmetros) o CSV sintético com N músicas
+generate_csv() {
+    local songs=$1
+    local file="$WORK_DIR/synth_${songs}_v${VOCAB}_z${ZIPF}_w${MEAN_WORDS}_s${LENGTH_SIGMA}_r${SEED}.csv"
+    if [ ! -f "$file" ]; then
+        ./synth_lyrics --songs "$songs" --vocab "$VOCAB" --zipf "$ZIPF" --mean-words "$MEAN_WORDS" \
+                       --length-sigma "$LENGTH_SIGMA" --seed "$SEED" -o "$file" >&2 || return 1
+    fi
+    echo "$file"
+}
+
+# Servidor falso do Ollama: a fase do LLM é medida sem depender de modelo nem de GPU
+python3 ollama_stub.py --port "$STUB_PORT" --delay-ms "$STUB_DELAY_MS" &
+STUB_PID=$!
+trap 'kill $STUB_PID 2>/dev/null' EXIT
+sleep 1
+if ! kill -0 $STUB_PID 2>/dev/null; then
+    echo "❌ Não foi possível iniciar o servidor falso do Ollama na porta $STUB_PORT"
+    exit 1
+fi
+
+# Executa o main e imprime o JSON de tempos produzido por --timings
+run_case() {
+    local np=$1
+    local csv=$2
+    local timings="$WORK_DIR/timings_$$.json"
+    rm -f "$timings"
+    # O cache de sentimentos fica desligado para que toda execução passe pelo servidor
+    mpirun -np "$np" $MPIRUN_ARGS ./main --input "$csv" $MAIN_ARGS --no-llm-cache \
+           --llm-url "http://127.0.0.1:$STUB_PORT" --timings "$timings" > "$WORK_DIR/last_run.log" 2>&1
+    if [ $? -ne 0 ] || [ ! -f "$timings" ]; then
+        echo "❌ Falha com $np processos (veja $WORK_DIR/last_run.log)" >&2
+        return 1
+    fi
+    cat "$timings"
+    rm -f "$timings"
+}
+
+# Junta os resultados de uma varredura num vetor JSON
+sweep() {
+    local kind=$1
+    local first=1
+    echo "["
+    for np in $RANKS; do
+        if [ "$kind" = "strong" ]; then
+            songs=$STRONG_SONGS
+        else
+            songs=$((WEAK_SONGS_PER_RANK * np))
+        fi
+        csv=$(generate_csv "$songs") || return 1
+        result=$(run_case "$np" "$csv") || return 1
+        seconds=$(echo "$result" | sed -n 's/.*"total_seconds": \([0-9.]*\).*/\1/p')
+        echo "  $kind: $np processo(s), $songs músicas -> ${seconds}s" >&2
+        [ $first -eq 1 ] || echo ","
+        echo "$result"
+        first=0
+    done
+    echo "]"
+}
+
+echo "🚀 Escalabilidade forte"
+strong=$(sweep strong) || exit 1
+echo "🚀 Escalabilidade fraca"
+weak=$(sweep weak) || exit 1
+
+cat > "$OUTPUT" <<EOF
+{
+"config": {"vocab": $VOCAB, "zipf": $ZIPF, "mean_words": $MEAN_WORDS, "length_sigma": $LENGTH_SIGMA, "seed": $SEED,
+           "strong_songs": $STRONG_SONGS, "weak_songs_per_rank": $WEAK_SONGS_PER_RANK, "stub_delay_ms": $STUB_DELAY_MS},
+"strong": $strong,
+"weak": $weak
+}
+EOF
+
+echo ""
+echo "✅ Resultados gravados em $OUTPUT"
@@ -33,10 +33,6 @@ if [ $? -eq 0 ]; then
     echo "Criando CSV de teste com $TEST_SONGS músicas..."
     head -$((TEST_SONGS + 1)) golden_music.csv > test_music.csv
     
-    # Modificar temporariamente o código para usar o arquivo de teste
-    sed -i 's/golden_music.csv/test_music.csv/g' main.c
-    make main
-    
     echo ""
     echo "🚀 TESTE 1: Execução PARALELA ($NUM_PROCESSES processos MPI)"
     echo "============================================================"
@@ -52,7 +48,7 @@ if [ $? -eq 0 ]; then
     
     # Medir tempo de execução paralela
     time_start_parallel=$(date +%s.%N)
-    timeout ${PARALLEL_TIMEOUT}s mpirun -np $NUM_PROCESSES --oversubscribe ./main > parallel_output.txt 2>&1
+    timeout ${PARALLEL_TIMEOUT}s mpirun -np $NUM_PROCESSES --oversubscribe ./main --input test_music.csv > parallel_output.txt 2>&1
     parallel_exit_code=$?
     time_end_parallel=$(date +%s.%N)
     
@@ -79,7 +75,7 @@ if [ $? -eq 0 ]; then
     
     # Medir tempo de execução single thread
     time_start_single=$(date +%s.%N)
-    timeout ${SINGLE_TIMEOUT}s mpirun -np 1 ./main > single_output.txt 2>&1
+    timeout ${SINGLE_TIMEOUT}s mpirun -np 1 ./main --input test_music.csv > single_output.txt 2>&1
     single_exit_code=$?
     time_end_single=$(date +%s.%N)
     
@@ -141,8 +137,6 @@ if [ $? -eq 0 ]; then
     echo "Log single thread (últimas 5 linhas):"
     tail -5 single_output.txt
     
-    # Restaurar arquivo original
-    sed -i 's/test_music.csv/golden_music.csv/g' main.c
     rm -f test_music.csv
     
 else
@@ -0,0 +1,93 @@
+#include "chunk_scheduler.h"
+#include <stdlib.h>    // Para funções de alocação de memória
+
+// Cria o distribuidor com o contador compartilhado no root
+ChunkScheduler* chunk_scheduler_create(int total, int initial_chunk, int root, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    ChunkScheduler *scheduler = malloc(sizeof(ChunkScheduler));
+    MPI_Comm_size(comm, &scheduler->world_size);
+    scheduler->root = root;
+    scheduler->total = total;
+    scheduler->chunk = initial_chunk;
+    scheduler->last_count = 0;
+    scheduler->last_end = 0;
+    scheduler->last_time = 0.0;
+    scheduler->chunks = 0;
+
+    // Apenas o root expõe memória: um contador com a próxima linha livre
+    MPI_Aint window_size = (rank == root) ? sizeof(long long) : 0;
+    MPI_Win_allocate(window_size, sizeof(long long), MPI_INFO_NULL, comm, &scheduler->counter, &scheduler->win);
+
+    // Época de acesso passiva aberta durante toda a passada
+    MPI_Win_lock_all(0, scheduler->win);
+
+    // O root zera o contador com escrita local; o MPI_Win_sync torna essa escrita
+    // visível à cópia pública da janela antes que a barreira libere o primeiro
+    // MPI_Fetch_and_op remoto (exigido no modelo de memória separado)
+    if (rank == root) {
+        *scheduler->counter = 0;
+        MPI_Win_sync(scheduler->win);
+    }
+    MPI_Barrier(comm);
+    return scheduler;
+}
+
+// Ajusta o tamanho do próximo pedaço pela vazão medida no anterior
+static void adapt_chunk(ChunkScheduler *scheduler, double now) {
+    if (scheduler->last_count > 0) {
+        double elapsed = now - scheduler->last_time;
+        if (elapsed > 0.0) {
+            // Linhas que cabem no tempo alvo; média com o tamanho atual para suavizar
+            double ideal = scheduler->last_count / elapsed * CHUNK_SCHEDULER_TARGET_SECONDS;
+            if (ideal > CHUNK_SCHEDULER_MAX_LINES) ideal = CHUNK_SCHEDULER_MAX_LINES;
+            scheduler->chunk = (scheduler->chunk + (int)ideal) / 2;
+        }
+    }
+
+    // Perto do fim, pedaços menores (fração do que resta) evitam que um processo
+    // fique com uma sobra grande enquanto os outros já terminaram
+    int remaining = scheduler->total - scheduler->last_end;
+    int guided = remaining / (2 * scheduler->world_size);
+    if (scheduler->chunk > guided) scheduler->chunk = guided;
+
+    if (scheduler->chunk < CHUNK_SCHEDULER_MIN_LINES) scheduler->chunk = CHUNK_SCHEDULER_MIN_LINES;
+    if (scheduler->chunk > CHUNK_SCHEDULER_MAX_LINES) scheduler->chunk = CHUNK_SCHEDULER_MAX_LINES;
+}
+
+// Reserva o próximo pedaço livre
+int chunk_scheduler_next(ChunkScheduler *scheduler, int *start, int *count) {
+    double now = MPI_Wtime();
+    if (scheduler->chunks > 0) {
+        adapt_chunk(scheduler, now);
+    }
+
+    // Soma atômica no contador remoto: devolve o início do pedaço reservado
+    long long amount = scheduler->chunk;
+    long long first;
+    MPI_Fetch_and_op(&amount, &first, MPI_LONG_LONG, scheduler->root, 0, MPI_SUM, scheduler->win);
+    MPI_Win_flush(scheduler->root, scheduler->win);
+
+    if (first >= scheduler->total) {
+        scheduler->last_count = 0;
+        return 0;
+    }
+
+    *start = (int)first;
+    *count = (first + amount > scheduler->total) ? (int)(scheduler->total - first) : (int)amount;
+    scheduler->last_count = *count;
+    scheduler->last_end = *start + *count;
+    scheduler->last_time = now;
+    scheduler->chunks++;
+    return 1;
+}
+
+// Libera o distribuidor e a janela compartilhada
+void chunk_scheduler_free(ChunkScheduler *scheduler) {
+    if (scheduler) {
+        MPI_Win_unlock_all(scheduler->win);
+        MPI_Win_free(&scheduler->win);  // Coletiva: espera todos terminarem
+        free(scheduler);
+    }
+}
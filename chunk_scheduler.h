@@ -0,0 +1,57 @@
+#ifndef CHUNK_SCHEDULER_H
+#define CHUNK_SCHEDULER_H
+
+// Inclusão das bibliotecas necessárias
+#include <mpi.h>      // Para o contador compartilhado (janela MPI de acesso remoto)
+
+// Limites do tamanho adaptativo dos pedaços (em linhas)
+#define CHUNK_SCHEDULER_MIN_LINES 16       // Menor pedaço entregue
+#define CHUNK_SCHEDULER_MAX_LINES 1024     // Maior pedaço entregue
+#define CHUNK_SCHEDULER_TARGET_SECONDS 0.05  // Duração desejada de cada pedaço
+
+// Distribuidor dinâmico de pedaços: a próxima linha livre fica num contador no
+// processo root e cada processo reserva o seu próximo pedaço com MPI_Fetch_and_op,
+// sem depender do root para responder. O tamanho do pedaço acompanha a vazão
+// medida por cada processo e encolhe perto do fim do arquivo.
+typedef struct {
+    MPI_Win win;            // Janela com o contador compartilhado
+    long long *counter;     // Memória da janela (usada apenas no root)
+    int root;               // Processo que guarda o contador
+    int world_size;         // Número de processos do comunicador
+    int total;              // Número total de linhas
+    int chunk;              // Tamanho atual do pedaço deste processo
+    int last_count;         // Linhas do último pedaço entregue
+    int last_end;           // Fim do último pedaço visto (estimativa do que resta)
+    double last_time;       // Instante (MPI_Wtime) em que o último pedaço foi entregue
+    int chunks;             // Pedaços entregues a este processo
+} ChunkScheduler;
+
+// Declarações das funções
+
+/**
+ * Cria o distribuidor (operação coletiva no comunicador)
+ * @param total Número total de linhas a distribuir
+ * @param initial_chunk Tamanho do primeiro pedaço de cada processo
+ * @param root Processo que guarda o contador
+ * @param comm Comunicador MPI
+ * @return Ponteiro para ChunkScheduler alocado
+ */
+ChunkScheduler* chunk_scheduler_create(int total, int initial_chunk, int root, MPI_Comm comm);
+
+/**
+ * Reserva o próximo pedaço livre. O tempo desde a chamada anterior é usado para
+ * medir a vazão do processo e ajustar o tamanho do pedaço seguinte.
+ * @param scheduler Distribuidor
+ * @param start Saída: primeira linha do pedaço
+ * @param count Saída: número de linhas do pedaço
+ * @return 1 se um pedaço foi reservado, 0 quando não há mais linhas
+ */
+int chunk_scheduler_next(ChunkScheduler *scheduler, int *start, int *count);
+
+/**
+ * Libera o distribuidor (operação coletiva no comunicador)
+ * @param scheduler Ponteiro para ChunkScheduler a ser liberado
+ */
+void chunk_scheduler_free(ChunkScheduler *scheduler);
+
+#endif // CHUNK_SCHEDULER_H
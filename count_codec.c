@@ -0,0 +1,109 @@
+#include "count_codec.h"
+#include <string.h>   // Para memcpy
+
+// Número de bytes de um inteiro sem sinal codificado como varint (LEB128)
+size_t count_codec_varint_size(uint64_t value) {
+    size_t n = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        n++;
+    }
+    return n;
+}
+
+// Escreve um inteiro sem sinal como varint: 7 bits por byte, bit alto = continua
+size_t count_codec_put_varint(char *dst, uint64_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        dst[n++] = (char)((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    dst[n++] = (char)value;
+    return n;
+}
+
+// Lê um varint com verificação de limites
+size_t count_codec_get_varint(const char *src, const char *end, uint64_t *value) {
+    uint64_t result = 0;
+    size_t n = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (src + n >= end) return 0;  // Varint truncado
+        unsigned char byte = (unsigned char)src[n++];
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return n;
+        }
+    }
+    return 0;  // Mais de 10 bytes: malformado
+}
+
+// Número de bytes de uma entrada no formato compacto
+size_t count_codec_entry_size(size_t key_len, uint64_t count) {
+    return count_codec_varint_size(key_len) + key_len + count_codec_varint_size(count);
+}
+
+// Escreve uma entrada no formato compacto
+size_t count_codec_write_entry(char *dst, const char *key, size_t key_len, uint64_t count) {
+    size_t n = count_codec_put_varint(dst, key_len);
+    memcpy(dst + n, key, key_len);
+    n += key_len;
+    n += count_codec_put_varint(dst + n, count);
+    return n;
+}
+
+// Número de bytes da tabela inteira no formato compacto
+size_t count_codec_table_size(const CountTable *table) {
+    size_t total = 0;
+    for (size_t i = 0; i < table->capacity; i++) {
+        const CountSlot *slot = &table->slots[i];
+        if (slot->hash == 0) continue;
+        total += count_codec_entry_size(slot->key_len, (uint64_t)slot->count);
+    }
+    return total;
+}
+
+// Escreve todas as entradas ocupadas da tabela no formato compacto
+size_t count_codec_encode_table(const CountTable *table, char *dst) {
+    size_t n = 0;
+    for (size_t i = 0; i < table->capacity; i++) {
+        const CountSlot *slot = &table->slots[i];
+        if (slot->hash == 0) continue;
+        n += count_codec_write_entry(dst + n, count_table_key(table, slot), slot->key_len, (uint64_t)slot->count);
+    }
+    return n;
+}
+
+// Lê a próxima entrada de um buffer no formato compacto
+int count_codec_next(const char **p, const char *end, const char **key, size_t *key_len, uint64_t *count) {
+    if (*p >= end) return 0;
+
+    uint64_t len;
+    size_t n = count_codec_get_varint(*p, end, &len);
+    if (n == 0 || len > (uint64_t)(end - *p - n)) return -1;
+    *key = *p + n;
+    *key_len = (size_t)len;
+
+    const char *q = *key + len;
+    n = count_codec_get_varint(q, end, count);
+    if (n == 0) return -1;
+    *p = q + n;
+    return 1;
+}
+
+// Soma na tabela todas as entradas de um buffer no formato compacto
+long long count_codec_merge(CountTable *table, const char *data, size_t size) {
+    const char *p = data;
+    const char *end = data + size;
+    const char *key;
+    size_t key_len;
+    uint64_t count;
+    long long entries = 0;
+    int status;
+
+    while ((status = count_codec_next(&p, end, &key, &key_len, &count)) == 1) {
+        count_table_add(table, key, key_len, (int)count);
+        entries++;
+    }
+    return status < 0 ? -1 : entries;
+}
@@ -0,0 +1,92 @@
+#ifndef COUNT_CODEC_H
+#define COUNT_CODEC_H
+
+// Inclusão das bibliotecas necessárias
+#include <stddef.h>          // Para size_t
+#include <stdint.h>          // Para inteiros de tamanho fixo
+#include "count_table.h"     // Para CountTable
+
+// Formato compacto de uma tabela de contagem para envio entre processos:
+// entradas consecutivas [varint tamanho da chave][bytes da chave][varint contagem],
+// sem preenchimento e sem '\0' (uma palavra de 5 letras ocupa 7 bytes em vez de 104)
+
+// Declarações das funções
+
+/**
+ * Número de bytes de um inteiro sem sinal codificado como varint (LEB128)
+ * @param value Valor a codificar
+ * @return Bytes ocupados (1 a 10)
+ */
+size_t count_codec_varint_size(uint64_t value);
+
+/**
+ * Escreve um inteiro sem sinal como varint
+ * @param dst Destino com espaço suficiente
+ * @param value Valor a codificar
+ * @return Bytes escritos
+ */
+size_t count_codec_put_varint(char *dst, uint64_t value);
+
+/**
+ * Lê um varint com verificação de limites
+ * @param src Início do varint
+ * @param end Fim do buffer
+ * @param value Valor decodificado
+ * @return Bytes lidos, ou 0 se o varint estiver truncado ou malformado
+ */
+size_t count_codec_get_varint(const char *src, const char *end, uint64_t *value);
+
+/**
+ * Número de bytes de uma entrada (chave + contagem) no formato compacto
+ * @param key_len Tamanho da chave
+ * @param count Contagem
+ * @return Bytes ocupados pela entrada
+ */
+size_t count_codec_entry_size(size_t key_len, uint64_t count);
+
+/**
+ * Escreve uma entrada no formato compacto
+ * @param dst Destino com pelo menos count_codec_entry_size bytes
+ * @param key Bytes da chave
+ * @param key_len Tamanho da chave
+ * @param count Contagem
+ * @return Bytes escritos
+ */
+size_t count_codec_write_entry(char *dst, const char *key, size_t key_len, uint64_t count);
+
+/**
+ * Número de bytes da tabela inteira no formato compacto
+ * @param table Tabela de contagem
+ * @return Bytes necessários para count_codec_encode_table
+ */
+size_t count_codec_table_size(const CountTable *table);
+
+/**
+ * Escreve todas as entradas ocupadas da tabela no formato compacto
+ * @param table Tabela de contagem
+ * @param dst Destino com pelo menos count_codec_table_size bytes
+ * @return Bytes escritos
+ */
+size_t count_codec_encode_table(const CountTable *table, char *dst);
+
+/**
+ * Lê a próxima entrada de um buffer no formato compacto
+ * @param p Posição atual (avança para a próxima entrada)
+ * @param end Fim do buffer
+ * @param key Saída: início da chave dentro do buffer
+ * @param key_len Saída: tamanho da chave
+ * @param count Saída: contagem
+ * @return 1 se leu uma entrada, 0 no fim do buffer, -1 se o buffer estiver malformado
+ */
+int count_codec_next(const char **p, const char *end, const char **key, size_t *key_len, uint64_t *count);
+
+/**
+ * Soma na tabela todas as entradas de um buffer no formato compacto
+ * @param table Tabela que recebe as contagens
+ * @param data Início do buffer
+ * @param size Tamanho do buffer
+ * @return Número de entradas lidas, ou -1 se o buffer estiver malformado
+ */
+long long count_codec_merge(CountTable *table, const char *data, size_t size);
+
+#endif // COUNT_CODEC_H
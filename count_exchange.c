@@ -0,0 +1,335 @@
+#include "count_exchange.h"
+#include <stdio.h>          // Para printf
+#include <stdlib.h>         // Para funções de alocação de memória
+#include <string.h>         // Para memcpy
+#include "count_codec.h"    // Para o formato compacto das contagens
+#include "rank_stats.h"     // Para separar o tempo de soma das tabelas do tempo de comunicação
+
+// Tags das mensagens da junção no root
+#define TAG_TABLE_SIZE 0    // Tamanho em bytes da tabela codificada
+#define TAG_TABLE_DATA 1    // Bytes da tabela codificada
+
+// Codifica as entradas indicadas por 'slots' num buffer compacto alocado
+static char* encode_slots(const CountTable *table, const size_t *slots, size_t n, int *bytes) {
+    int total = 0;
+    for (size_t i = 0; i < n; i++) {
+        const CountSlot *slot = &table->slots[slots[i]];
+        total += (int)count_codec_entry_size(slot->key_len, (uint64_t)slot->count);
+    }
+    char *data = malloc(total > 0 ? total : 1);
+    int written = 0;
+    for (size_t i = 0; i < n; i++) {
+        const CountSlot *slot = &table->slots[slots[i]];
+        written += (int)count_codec_write_entry(data + written, count_table_key(table, slot), slot->key_len, (uint64_t)slot->count);
+    }
+    *bytes = total;
+    return data;
+}
+
+// Reúne no root os buffers de todos os processos (MPI_Gather dos tamanhos + MPI_Gatherv)
+char* count_exchange_gather_bytes(const char *data, int bytes, int *total, int root, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    int *counts = NULL;
+    int *displs = NULL;
+    char *all = NULL;
+    *total = 0;
+    if (rank == root) {
+        counts = malloc(size * sizeof(int));
+        displs = malloc(size * sizeof(int));
+    }
+    MPI_Gather(&bytes, 1, MPI_INT, counts, 1, MPI_INT, root, comm);
+    if (rank == root) {
+        for (int proc = 0; proc < size; proc++) {
+            displs[proc] = *total;
+            *total += counts[proc];
+        }
+        all = malloc(*total > 0 ? *total : 1);
+    }
+    MPI_Gatherv(data, bytes, MPI_BYTE, all, counts, displs, MPI_BYTE, root, comm);
+    if (rank != root) rank_stats_add(STAT_BYTES_SENT, bytes);
+
+    free(counts);
+    free(displs);
+    return all;
+}
+
+// Compara índices de entradas (para busca binária no top-K local)
+static int compare_size_t(const void *a, const void *b) {
+    size_t x = *(const size_t*)a;
+    size_t y = *(const size_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Processo dono de uma chave na redução particionada
+int count_exchange_owner(uint64_t hash, int world_size) {
+    return (int)((hash >> 32) % (uint64_t)world_size);
+}
+
+// Junção no root: os demais processos enviam a tabela no formato compacto
+void count_exchange_gather(CountTable *table, int root, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    if (rank == root) {
+        // Recebe as tabelas dos demais processos e as soma na tabela do root
+        for (int proc = 0; proc < size; proc++) {
+            if (proc == root) continue;
+            int bytes;
+            MPI_Recv(&bytes, 1, MPI_INT, proc, TAG_TABLE_SIZE, comm, MPI_STATUS_IGNORE);
+
+            char *data = malloc(bytes > 0 ? bytes : 1);
+            MPI_Recv(data, bytes, MPI_BYTE, proc, TAG_TABLE_DATA, comm, MPI_STATUS_IGNORE);
+            StatActivity previous = rank_stats_enter(STAT_MERGE);
+            count_codec_merge(table, data, bytes);
+            rank_stats_enter(previous);
+            free(data);
+        }
+    } else {
+        // Envia a tabela compactada ao root
+        int bytes = (int)count_codec_table_size(table);
+        char *data = malloc(bytes > 0 ? bytes : 1);
+        count_codec_encode_table(table, data);
+
+        MPI_Send(&bytes, 1, MPI_INT, root, TAG_TABLE_SIZE, comm);
+        MPI_Send(data, bytes, MPI_BYTE, root, TAG_TABLE_DATA, comm);
+        rank_stats_add(STAT_BYTES_SENT, bytes);
+        free(data);
+    }
+}
+
+// Redução particionada por hash com troca MPI_Alltoallv
+CountTable* count_exchange_shuffle(const CountTable *local, int top_k, long long *total_keys, int root, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    // 1. Conta quantos bytes vão para cada dono
+    int *send_counts = calloc(size, sizeof(int));
+    int *send_displs = malloc(size * sizeof(int));
+    int *recv_counts = malloc(size * sizeof(int));
+    int *recv_displs = malloc(size * sizeof(int));
+    for (size_t i = 0; i < local->capacity; i++) {
+        const CountSlot *slot = &local->slots[i];
+        if (slot->hash == 0) continue;
+        send_counts[count_exchange_owner(slot->hash, size)] += (int)count_codec_entry_size(slot->key_len, (uint64_t)slot->count);
+    }
+
+    // 2. Monta os baldes contíguos por dono, já no formato compacto
+    int send_total = 0;
+    for (int proc = 0; proc < size; proc++) {
+        send_displs[proc] = send_total;
+        send_total += send_counts[proc];
+    }
+    char *send_buffer = malloc(send_total > 0 ? send_total : 1);
+    int *fill = calloc(size, sizeof(int));
+    for (size_t i = 0; i < local->capacity; i++) {
+        const CountSlot *slot = &local->slots[i];
+        if (slot->hash == 0) continue;
+        int owner = count_exchange_owner(slot->hash, size);
+        fill[owner] += (int)count_codec_write_entry(send_buffer + send_displs[owner] + fill[owner],
+                                                    count_table_key(local, slot), slot->key_len, (uint64_t)slot->count);
+    }
+    free(fill);
+
+    // 3. Troca os baldes: cada processo recebe apenas as chaves que lhe pertencem
+    MPI_Alltoall(send_counts, 1, MPI_INT, recv_counts, 1, MPI_INT, comm);
+    int recv_total = 0;
+    for (int proc = 0; proc < size; proc++) {
+        recv_displs[proc] = recv_total;
+        recv_total += recv_counts[proc];
+    }
+    char *recv_buffer = malloc(recv_total > 0 ? recv_total : 1);
+    MPI_Alltoallv(send_buffer, send_counts, send_displs, MPI_BYTE,
+                  recv_buffer, recv_counts, recv_displs, MPI_BYTE, comm);
+    free(send_buffer);
+    rank_stats_add(STAT_BYTES_SENT, send_total - send_counts[rank]);
+
+    // 4. Reduz a faixa própria de chaves
+    StatActivity previous = rank_stats_enter(STAT_MERGE);
+    CountTable *owned = count_table_create(recv_total / 8);
+    count_codec_merge(owned, recv_buffer, recv_total);
+    free(recv_buffer);
+    rank_stats_enter(previous);
+
+    // 5. Total de chaves distintas = soma das faixas (cada chave tem um único dono)
+    long long owned_keys = (long long)owned->size;
+    MPI_Reduce(&owned_keys, total_keys, 1, MPI_LONG_LONG, MPI_SUM, root, comm);
+
+    // 6. Cada dono seleciona (heap de tamanho K) e codifica apenas o seu top-K
+    size_t *order = malloc((top_k > 0 ? top_k : 1) * sizeof(size_t));
+    size_t n = count_table_top_k(owned, top_k, order);
+    int top_bytes;
+    char *top_buffer = encode_slots(owned, order, n, &top_bytes);
+    free(order);
+    count_table_free(owned);
+
+    // 7. O root recebe os top-K de todos os donos; as contagens já são exatas
+    int top_total;
+    char *all_top = count_exchange_gather_bytes(top_buffer, top_bytes, &top_total, root, comm);
+    free(top_buffer);
+
+    CountTable *result = NULL;
+    if (rank == root) {
+        result = count_table_create((size_t)size * top_k);
+        count_codec_merge(result, all_top, top_total);
+        free(all_top);
+    }
+
+    free(send_counts);
+    free(send_displs);
+    free(recv_counts);
+    free(recv_displs);
+    return result;
+}
+
+// Top-K exato em três fases com limiar (TPUT)
+CountTable* count_exchange_tput(const CountTable *local, int top_k, int root, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    CountTable *sums = NULL;       // Root: soma parcial (limite inferior) de cada chave vista
+    CountTable *reporters = NULL;  // Root: quantos processos já informaram cada chave
+    size_t *top = malloc((top_k > 0 ? top_k : 1) * sizeof(size_t));         // Top-K local enviado na fase 1
+    size_t *global_top = malloc((top_k > 0 ? top_k : 1) * sizeof(size_t));  // Root: top-K das somas parciais
+    int bytes, total;
+    char *data, *all;
+    const char *p, *end, *key;
+    size_t key_len;
+    uint64_t count;
+
+    // Fase 1: top-K local de cada processo
+    size_t num_top = count_table_top_k(local, top_k, top);
+    data = encode_slots(local, top, num_top, &bytes);
+    all = count_exchange_gather_bytes(data, bytes, &total, root, comm);
+    free(data);
+
+    long long threshold = 0;  // T: processos enviam na fase 2 as chaves com contagem >= T
+    long long phase1_keys = 0;
+    if (rank == root) {
+        sums = count_table_create((size_t)size * top_k);
+        reporters = count_table_create((size_t)size * top_k);
+        p = all;
+        end = all + total;
+        while (count_codec_next(&p, end, &key, &key_len, &count) == 1) {
+            count_table_add(sums, key, key_len, (int)count);
+            count_table_add(reporters, key, key_len, 1);
+            phase1_keys++;
+        }
+        free(all);
+
+        // tau1 = K-ésima maior soma parcial; uma chave fora do top-K de todos os
+        // processos e abaixo de T em todos soma no máximo size*(T-1) < tau1
+        size_t n = count_table_top_k(sums, top_k, global_top);
+        long long tau1 = (n == (size_t)top_k) ? sums->slots[global_top[n - 1]].count : 0;
+        threshold = (tau1 + size - 1) / size;
+    }
+    MPI_Bcast(&threshold, 1, MPI_LONG_LONG, root, comm);
+
+    // Fase 2: chaves com contagem >= T que ainda não foram enviadas na fase 1
+    qsort(top, num_top, sizeof(size_t), compare_size_t);
+    size_t *selected = malloc((local->size > 0 ? local->size : 1) * sizeof(size_t));
+    size_t num_selected = 0;
+    for (size_t i = 0; i < local->capacity; i++) {
+        if (local->slots[i].hash == 0 || local->slots[i].count < threshold) continue;
+        if (bsearch(&i, top, num_top, sizeof(size_t), compare_size_t)) continue;
+        selected[num_selected++] = i;
+    }
+    data = encode_slots(local, selected, num_selected, &bytes);
+    free(selected);
+    all = count_exchange_gather_bytes(data, bytes, &total, root, comm);
+    free(data);
+
+    // Root: poda pelos limites inferior (soma parcial) e superior
+    // (soma parcial + (T-1) para cada processo que não informou a chave)
+    char *candidates = NULL;
+    int candidate_bytes = 0;
+    long long phase2_keys = 0;
+    if (rank == root) {
+        p = all;
+        end = all + total;
+        while (count_codec_next(&p, end, &key, &key_len, &count) == 1) {
+            count_table_add(sums, key, key_len, (int)count);
+            count_table_add(reporters, key, key_len, 1);
+            phase2_keys++;
+        }
+        free(all);
+
+        size_t n = count_table_top_k(sums, top_k, global_top);
+        long long tau2 = (n == (size_t)top_k) ? sums->slots[global_top[n - 1]].count : 0;
+        long long missing_max = threshold > 0 ? threshold - 1 : 0;
+
+        size_t *kept = malloc((sums->size > 0 ? sums->size : 1) * sizeof(size_t));
+        size_t num_kept = 0;
+        for (size_t i = 0; i < sums->capacity; i++) {
+            const CountSlot *slot = &sums->slots[i];
+            if (slot->hash == 0) continue;
+            int reported = count_table_get(reporters, count_table_key(sums, slot), slot->key_len);
+            long long upper = slot->count + (long long)(size - reported) * missing_max;
+            if (upper >= tau2) kept[num_kept++] = i;
+        }
+
+        // Os candidatos vão sem contagem: cada processo responde com a sua
+        for (size_t i = 0; i < num_kept; i++) sums->slots[kept[i]].count = 0;
+        candidates = encode_slots(sums, kept, num_kept, &candidate_bytes);
+        free(kept);
+
+        printf("TPUT: fase 1 %lld chaves, limiar T=%lld, fase 2 %lld chaves, %zu candidatos\n",
+               phase1_keys, threshold, phase2_keys, num_kept);
+        count_table_free(reporters);
+        count_table_free(sums);
+    }
+    free(top);
+    free(global_top);
+
+    // Fase 3: transmite os candidatos; cada processo devolve as contagens na mesma ordem
+    MPI_Bcast(&candidate_bytes, 1, MPI_INT, root, comm);
+    if (rank != root) candidates = malloc(candidate_bytes > 0 ? candidate_bytes : 1);
+    MPI_Bcast(candidates, candidate_bytes, MPI_BYTE, root, comm);
+
+    long long num_candidates = 0;
+    p = candidates;
+    end = candidates + candidate_bytes;
+    while (count_codec_next(&p, end, &key, &key_len, &count) == 1) num_candidates++;
+
+    data = malloc(num_candidates > 0 ? num_candidates * 10 : 1);
+    bytes = 0;
+    p = candidates;
+    while (count_codec_next(&p, end, &key, &key_len, &count) == 1) {
+        bytes += (int)count_codec_put_varint(data + bytes, (uint64_t)count_table_get(local, key, key_len));
+    }
+    all = count_exchange_gather_bytes(data, bytes, &total, root, comm);
+    free(data);
+
+    CountTable *result = NULL;
+    if (rank == root) {
+        // Soma as respostas de cada processo, candidato a candidato
+        long long *exact = calloc(num_candidates > 0 ? num_candidates : 1, sizeof(long long));
+        const char *q = all;
+        const char *q_end = all + total;
+        long long c = 0;
+        while (q < q_end) {
+            size_t n = count_codec_get_varint(q, q_end, &count);
+            if (n == 0) break;
+            q += n;
+            exact[c] += (long long)count;
+            if (++c == num_candidates) c = 0;
+        }
+
+        result = count_table_create((size_t)num_candidates);
+        c = 0;
+        p = candidates;
+        while (count_codec_next(&p, end, &key, &key_len, &count) == 1) {
+            if (exact[c] > 0) count_table_add(result, key, key_len, (int)exact[c]);
+            c++;
+        }
+        free(exact);
+        free(all);
+    }
+    free(candidates);
+    return result;
+}
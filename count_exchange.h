@@ -0,0 +1,70 @@
+#ifndef COUNT_EXCHANGE_H
+#define COUNT_EXCHANGE_H
+
+// Inclusão das bibliotecas necessárias
+#include <mpi.h>            // Para a troca de contagens entre processos
+#include "count_table.h"    // Para CountTable
+
+// Declarações das funções
+
+/**
+ * Processo dono de uma chave na redução particionada (usa os bits altos do hash,
+ * independentes dos bits baixos usados para posicionar a chave na tabela)
+ * @param hash Hash da chave
+ * @param world_size Número total de processos
+ * @return Rank responsável por reduzir a chave
+ */
+int count_exchange_owner(uint64_t hash, int world_size);
+
+/**
+ * Reúne no root buffers de tamanho variável de todos os processos, em ordem de rank
+ * (MPI_Gather dos tamanhos + MPI_Gatherv)
+ * @param data Buffer local
+ * @param bytes Tamanho do buffer local
+ * @param total Saída no root: soma dos tamanhos recebidos
+ * @param root Processo que recebe os buffers
+ * @param comm Comunicador MPI
+ * @return No root, buffer alocado com todos os dados; NULL nos demais processos
+ */
+char* count_exchange_gather_bytes(const char *data, int bytes, int *total, int root, MPI_Comm comm);
+
+/**
+ * Junção no root: os demais processos enviam a tabela inteira no formato
+ * compacto e o root soma tudo na sua própria tabela
+ * @param table Tabela local (no root passa a conter o total de todos os processos)
+ * @param root Processo que recebe as tabelas
+ * @param comm Comunicador MPI
+ */
+void count_exchange_gather(CountTable *table, int root, MPI_Comm comm);
+
+/**
+ * Redução particionada por hash: cada processo separa suas chaves por dono,
+ * troca os baldes com MPI_Alltoallv, reduz apenas as chaves que lhe pertencem
+ * e envia ao root somente o seu top-K
+ * @param local Tabela local deste processo (não é alterada)
+ * @param top_k Número de chaves que cada dono envia ao root
+ * @param total_keys Saída no root: número total de chaves distintas
+ * @param root Processo que recebe o resultado final
+ * @param comm Comunicador MPI
+ * @return No root, tabela com os top-K de todos os donos (chaves disjuntas e
+ *         contagens exatas); NULL nos demais processos
+ */
+CountTable* count_exchange_shuffle(const CountTable *local, int top_k, long long *total_keys, int root, MPI_Comm comm);
+
+/**
+ * Top-K exato em três fases com limiar (TPUT), sem enviar as tabelas inteiras:
+ * 1) cada processo envia seu top-K local e o root calcula o limiar T;
+ * 2) cada processo envia as chaves com contagem >= T e o root descarta as que
+ *    não podem mais entrar no top-K;
+ * 3) os candidatos restantes são transmitidos e cada processo devolve suas
+ *    contagens exatas para eles
+ * @param local Tabela local deste processo (não é alterada)
+ * @param top_k Número de chaves do resultado
+ * @param root Processo que recebe o resultado final
+ * @param comm Comunicador MPI
+ * @return No root, tabela com os candidatos e suas contagens exatas (contém o
+ *         top-K global); NULL nos demais processos
+ */
+CountTable* count_exchange_tput(const CountTable *local, int top_k, int root, MPI_Comm comm);
+
+#endif // COUNT_EXCHANGE_H
@@ -0,0 +1,216 @@
+#include "count_table.h"
+#include <stdlib.h>   // Para funções de alocação de memória
+#include <string.h>   // Para memcmp e memcpy
+
+#define COUNT_TABLE_ARENA_INITIAL 4096  // Tamanho inicial da arena de chaves
+
+// Cria uma tabela de contagem vazia
+CountTable* count_table_create(size_t expected_keys) {
+    CountTable *table = malloc(sizeof(CountTable));
+
+    // Mantém a ocupação abaixo de 75% para sondagens curtas
+    size_t capacity = 16;
+    while (capacity * 3 < expected_keys * 4) capacity *= 2;
+
+    table->slots = calloc(capacity, sizeof(CountSlot));
+    table->capacity = capacity;
+    table->size = 0;
+    table->arena = malloc(COUNT_TABLE_ARENA_INITIAL);
+    table->arena_used = 0;
+    table->arena_capacity = COUNT_TABLE_ARENA_INITIAL;
+    return table;
+}
+
+// Libera a memória da tabela e da arena
+void count_table_free(CountTable *table) {
+    if (table) {
+        free(table->slots);  // Libera as entradas
+        free(table->arena);  // Libera as chaves internadas
+        free(table);         // Libera a estrutura principal
+    }
+}
+
+// Hash FNV-1a com mistura final (os bits baixos escolhem a posição na tabela)
+uint64_t count_table_hash(const char *key, size_t len) {
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)key[i];
+        h *= 1099511628211ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h ? h : 1;  // 0 é reservado para entradas vazias
+}
+
+// Copia a chave para a arena, dobrando-a quando necessário
+static uint64_t intern_key(CountTable *table, const char *key, size_t len) {
+    if (table->arena_used + len + 1 > table->arena_capacity) {
+        while (table->arena_used + len + 1 > table->arena_capacity) {
+            table->arena_capacity *= 2;
+        }
+        table->arena = realloc(table->arena, table->arena_capacity);
+    }
+    uint64_t offset = table->arena_used;
+    memcpy(table->arena + offset, key, len);
+    table->arena[offset + len] = '\0';
+    table->arena_used += len + 1;
+    return offset;
+}
+
+// Dobra a capacidade e reposiciona as entradas (o hash guardado evita recalcular)
+static void grow_table(CountTable *table) {
+    size_t new_capacity = table->capacity * 2;
+    size_t mask = new_capacity - 1;
+    CountSlot *new_slots = calloc(new_capacity, sizeof(CountSlot));
+
+    for (size_t i = 0; i < table->capacity; i++) {
+        if (table->slots[i].hash == 0) continue;
+        size_t pos = (size_t)table->slots[i].hash & mask;
+        while (new_slots[pos].hash != 0) pos = (pos + 1) & mask;
+        new_slots[pos] = table->slots[i];
+    }
+
+    free(table->slots);
+    table->slots = new_slots;
+    table->capacity = new_capacity;
+}
+
+// Soma um valor à contagem da chave, inserindo-a se ainda não existir
+void count_table_add(CountTable *table, const char *key, size_t len, int amount) {
+    count_table_add_hashed(table, count_table_hash(key, len), key, len, amount);
+}
+
+// Igual a count_table_add, reaproveitando um hash já calculado
+void count_table_add_hashed(CountTable *table, uint64_t hash, const char *key, size_t len, int amount) {
+    size_t mask = table->capacity - 1;
+    size_t pos = (size_t)hash & mask;
+
+    // Sondagem linear: compara a impressão digital antes dos bytes da chave
+    while (table->slots[pos].hash != 0) {
+        CountSlot *slot = &table->slots[pos];
+        if (slot->hash == hash && slot->key_len == len &&
+            memcmp(table->arena + slot->key_offset, key, len) == 0) {
+            slot->count += amount;
+            return;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    // Chave nova: cresce antes de passar de 75% de ocupação
+    if ((table->size + 1) * 4 > table->capacity * 3) {
+        grow_table(table);
+        mask = table->capacity - 1;
+        pos = (size_t)hash & mask;
+        while (table->slots[pos].hash != 0) pos = (pos + 1) & mask;
+    }
+
+    CountSlot *slot = &table->slots[pos];
+    slot->hash = hash;
+    slot->key_offset = intern_key(table, key, len);
+    slot->key_len = (uint32_t)len;
+    slot->count = amount;
+    table->size++;
+}
+
+// Soma todas as contagens de uma tabela em outra
+void count_table_merge(CountTable *dst, const CountTable *src) {
+    for (size_t i = 0; i < src->capacity; i++) {
+        const CountSlot *slot = &src->slots[i];
+        if (slot->hash == 0) continue;
+        count_table_add_hashed(dst, slot->hash, src->arena + slot->key_offset, slot->key_len, slot->count);
+    }
+}
+
+// Consulta a contagem de uma chave sem inseri-la
+int count_table_get(const CountTable *table, const char *key, size_t len) {
+    uint64_t hash = count_table_hash(key, len);
+    size_t mask = table->capacity - 1;
+    size_t pos = (size_t)hash & mask;
+
+    while (table->slots[pos].hash != 0) {
+        const CountSlot *slot = &table->slots[pos];
+        if (slot->hash == hash && slot->key_len == len &&
+            memcmp(table->arena + slot->key_offset, key, len) == 0) {
+            return slot->count;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return 0;
+}
+
+// Verdadeiro se a entrada a vem antes da b no ranking (maior contagem; empate pela chave)
+static int ranks_before(const CountTable *table, size_t a, size_t b) {
+    const CountSlot *slot_a = &table->slots[a];
+    const CountSlot *slot_b = &table->slots[b];
+    if (slot_a->count != slot_b->count) return slot_a->count > slot_b->count;
+    return strcmp(table->arena + slot_a->key_offset, table->arena + slot_b->key_offset) < 0;
+}
+
+// Desce a entrada i no heap de mínimo (a raiz é a pior entrada selecionada)
+static void sift_down(const CountTable *table, size_t *heap, size_t n, size_t i) {
+    for (;;) {
+        size_t worst = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+        if (left < n && ranks_before(table, heap[worst], heap[left])) worst = left;
+        if (right < n && ranks_before(table, heap[worst], heap[right])) worst = right;
+        if (worst == i) return;
+        size_t tmp = heap[i];
+        heap[i] = heap[worst];
+        heap[worst] = tmp;
+        i = worst;
+    }
+}
+
+// Soma das contagens de todas as chaves
+long long count_table_total(const CountTable *table) {
+    long long total = 0;
+    for (size_t i = 0; i < table->capacity; i++) {
+        if (table->slots[i].hash != 0) total += table->slots[i].count;
+    }
+    return total;
+}
+
+// Seleciona as k maiores contagens com um heap de tamanho k
+size_t count_table_top_k(const CountTable *table, size_t k, size_t *out) {
+    size_t n = 0;
+    if (k == 0) return 0;
+
+    for (size_t i = 0; i < table->capacity; i++) {
+        if (table->slots[i].hash == 0) continue;
+        if (n < k) {
+            // Heap ainda incompleto: insere e sobe a entrada
+            size_t child = n++;
+            out[child] = i;
+            while (child > 0) {
+                size_t parent = (child - 1) / 2;
+                if (!ranks_before(table, out[parent], out[child])) break;
+                size_t tmp = out[parent];
+                out[parent] = out[child];
+                out[child] = tmp;
+                child = parent;
+            }
+        } else if (ranks_before(table, i, out[0])) {
+            // Melhor que a pior selecionada: substitui a raiz
+            out[0] = i;
+            sift_down(table, out, n, 0);
+        }
+    }
+
+    // Extrai a pior entrada para o final repetidamente: o vetor fica em ordem decrescente
+    for (size_t m = n; m > 1; m--) {
+        size_t tmp = out[0];
+        out[0] = out[m - 1];
+        out[m - 1] = tmp;
+        sift_down(table, out, m - 1, 0);
+    }
+    return n;
+}
+
+// Obtém a chave internada de uma entrada ocupada
+const char* count_table_key(const CountTable *table, const CountSlot *slot) {
+    return table->arena + slot->key_offset;
+}
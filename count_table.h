@@ -0,0 +1,111 @@
+#ifndef COUNT_TABLE_H
+#define COUNT_TABLE_H
+
+// Inclusão das bibliotecas necessárias
+#include <stddef.h>   // Para size_t
+#include <stdint.h>   // Para inteiros de tamanho fixo
+
+// Entrada da tabela: impressão digital do hash + posição da chave na arena
+typedef struct {
+    uint64_t hash;        // Hash completo da chave (0 = entrada vazia)
+    uint64_t key_offset;  // Posição da chave (terminada em '\0') na arena
+    uint32_t key_len;     // Tamanho da chave
+    int count;            // Contagem acumulada
+} CountSlot;
+
+// Tabela de contagem com endereçamento aberto (sondagem linear) e chaves
+// internadas em uma arena contínua, em vez de strings fixas por entrada.
+// Começa pequena e dobra quando passa de 75% de ocupação, sem limite fixo de chaves.
+typedef struct {
+    CountSlot *slots;       // Vetor de entradas (capacidade potência de 2)
+    size_t capacity;        // Número de entradas do vetor
+    size_t size;            // Número de chaves distintas armazenadas
+    char *arena;            // Bytes das chaves internadas
+    size_t arena_used;      // Bytes ocupados na arena
+    size_t arena_capacity;  // Bytes alocados para a arena
+} CountTable;
+
+// Declarações das funções
+
+/**
+ * Cria uma tabela de contagem vazia
+ * @param expected_keys Estimativa inicial de chaves distintas (a tabela cresce além dela)
+ * @return Ponteiro para CountTable alocada
+ */
+CountTable* count_table_create(size_t expected_keys);
+
+/**
+ * Libera a memória da tabela e da arena
+ * @param table Ponteiro para CountTable a ser liberada
+ */
+void count_table_free(CountTable *table);
+
+/**
+ * Calcula o hash de 64 bits de uma chave
+ * @param key Bytes da chave
+ * @param len Tamanho da chave
+ * @return Hash da chave (nunca 0)
+ */
+uint64_t count_table_hash(const char *key, size_t len);
+
+/**
+ * Soma um valor à contagem da chave, inserindo-a se ainda não existir
+ * @param table Tabela de contagem
+ * @param key Bytes da chave (não precisa terminar em '\0')
+ * @param len Tamanho da chave
+ * @param amount Valor a somar
+ */
+void count_table_add(CountTable *table, const char *key, size_t len, int amount);
+
+/**
+ * Igual a count_table_add, reaproveitando um hash já calculado
+ * @param table Tabela de contagem
+ * @param hash Hash da chave (obtido com count_table_hash)
+ * @param key Bytes da chave
+ * @param len Tamanho da chave
+ * @param amount Valor a somar
+ */
+void count_table_add_hashed(CountTable *table, uint64_t hash, const char *key, size_t len, int amount);
+
+/**
+ * Soma todas as contagens de uma tabela em outra (reaproveita os hashes já calculados)
+ * @param dst Tabela que recebe as contagens
+ * @param src Tabela de origem (não é alterada)
+ */
+void count_table_merge(CountTable *dst, const CountTable *src);
+
+/**
+ * Consulta a contagem de uma chave sem inseri-la
+ * @param table Tabela de contagem
+ * @param key Bytes da chave
+ * @param len Tamanho da chave
+ * @return Contagem da chave, ou 0 se ela não existir
+ */
+int count_table_get(const CountTable *table, const char *key, size_t len);
+
+/**
+ * Soma das contagens de todas as chaves
+ * @param table Tabela de contagem
+ * @return Total das contagens
+ */
+long long count_table_total(const CountTable *table);
+
+/**
+ * Seleciona as k maiores contagens com um heap de tamanho k (sem ordenar a tabela inteira).
+ * Empates são desfeitos pela ordem alfabética da chave, para um resultado determinístico.
+ * @param table Tabela de contagem
+ * @param k Número de entradas desejadas
+ * @param out Vetor com espaço para k posições; recebe os índices das entradas em ordem decrescente
+ * @return Número de entradas selecionadas (menor que k se a tabela tiver menos chaves)
+ */
+size_t count_table_top_k(const CountTable *table, size_t k, size_t *out);
+
+/**
+ * Obtém a chave internada de uma entrada ocupada
+ * @param table Tabela de contagem
+ * @param slot Entrada ocupada da tabela
+ * @return Chave terminada em '\0'
+ */
+const char* count_table_key(const CountTable *table, const CountSlot *slot);
+
+#endif // COUNT_TABLE_H
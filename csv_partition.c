@@ -0,0 +1,152 @@
+#include "csv_partition.h"
+#include <stdlib.h>    // Para funções de alocação de memória
+#include <string.h>    // Para memchr, memcpy e memmove
+
+#define CSV_PARTITION_TAG 15  // Tag das mensagens com pedaços de linha entre vizinhos
+
+// Lê [begin, end) em chamadas coletivas de até CSV_PARTITION_MAX_READ bytes. Todos os
+// processos fazem o mesmo número de chamadas (calculado a partir da maior faixa).
+static int read_range(MPI_File file, long long begin, long long end, long long max_range, char *buffer) {
+    int rounds = (int)((max_range + CSV_PARTITION_MAX_READ - 1) / CSV_PARTITION_MAX_READ);
+    long long done = 0;
+    int error = 0;
+
+    for (int r = 0; r < rounds; r++) {
+        long long left = end - begin - done;
+        int count = (left > CSV_PARTITION_MAX_READ) ? CSV_PARTITION_MAX_READ : (int)left;
+        MPI_Status status;
+        int received = 0;
+        if (MPI_File_read_at_all(file, (MPI_Offset)(begin + done), buffer + done, count, MPI_CHAR, &status) != MPI_SUCCESS) {
+            error = 1;
+        } else {
+            MPI_Get_count(&status, MPI_CHAR, &received);
+            if (received != count) error = 1;
+        }
+        done += count;
+    }
+    return error ? -1 : 0;
+}
+
+// Monta os offsets das linhas de data[0, len); a última linha pode não ter '\n'
+static void index_lines(LineIndex *index, const char *data, long long len) {
+    int count = 0;
+    for (long long start = 0; start < len; count++) {
+        const char *newline = memchr(data + start, '\n', (size_t)(len - start));
+        start = newline ? (newline - data) + 1 : len;
+    }
+
+    index->num_lines = count;
+    index->offsets = malloc((count + 1) * sizeof(long long));
+    int line = 0;
+    for (long long start = 0; start < len; line++) {
+        index->offsets[line] = start;
+        const char *newline = memchr(data + start, '\n', (size_t)(len - start));
+        start = newline ? (newline - data) + 1 : len;
+    }
+    index->offsets[count] = len;
+}
+
+// Lê a faixa deste processo do CSV
+CsvPartition* csv_partition_read(const char *filename, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    MPI_File file;
+    if (MPI_File_open(comm, filename, MPI_MODE_RDONLY, MPI_INFO_NULL, &file) != MPI_SUCCESS) {
+        return NULL;
+    }
+    MPI_Offset file_size;
+    MPI_File_get_size(file, &file_size);
+    if (file_size <= 0) {
+        MPI_File_close(&file);
+        return NULL;
+    }
+
+    // Faixas de bytes do mesmo tamanho, sem olhar para o conteúdo
+    long long begin = (long long)file_size * rank / size;
+    long long end = (long long)file_size * (rank + 1) / size;
+    long long length = end - begin;
+    char *data = malloc(length + 1);
+    int error = read_range(file, begin, end, (long long)file_size / size + 1, data);
+    MPI_File_close(&file);
+    MPI_Allreduce(MPI_IN_PLACE, &error, 1, MPI_INT, MPI_MAX, comm);
+    if (error) {
+        free(data);
+        return NULL;
+    }
+
+    // Até o primeiro '\n' a faixa continua a linha do vizinho da esquerda
+    long long head = 0;
+    int has_newline = 1;
+    if (rank > 0) {
+        const char *newline = memchr(data, '\n', (size_t)length);
+        has_newline = newline != NULL;
+        head = newline ? (newline - data) + 1 : length;
+    }
+
+    // Envia o pedaço inicial à esquerda e recebe o final da última linha da direita.
+    // Uma faixa sem '\n' está inteira dentro de uma linha: repassa tudo, junto com o
+    // que recebeu, depois de ouvir o vizinho da direita.
+    MPI_Request request = MPI_REQUEST_NULL;
+    if (rank > 0 && has_newline) {
+        MPI_Isend(data, (int)head, MPI_CHAR, rank - 1, CSV_PARTITION_TAG, comm, &request);
+    }
+    char *carry = NULL;
+    int carry_len = 0;
+    if (rank < size - 1) {
+        MPI_Status status;
+        MPI_Probe(rank + 1, CSV_PARTITION_TAG, comm, &status);
+        MPI_Get_count(&status, MPI_CHAR, &carry_len);
+        carry = malloc(carry_len + 1);
+        MPI_Recv(carry, carry_len, MPI_CHAR, rank + 1, CSV_PARTITION_TAG, comm, MPI_STATUS_IGNORE);
+    }
+    if (rank > 0 && !has_newline) {
+        data = realloc(data, length + carry_len + 1);
+        memcpy(data + length, carry, carry_len);
+        MPI_Send(data, (int)(length + carry_len), MPI_CHAR, rank - 1, CSV_PARTITION_TAG, comm);
+        length = 0;
+        head = 0;
+        carry_len = 0;
+    }
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+
+    // Linhas locais: a faixa sem o pedaço inicial, completada com o que veio da direita
+    long long body = length - head;
+    memmove(data, data + head, (size_t)body);
+    data = realloc(data, body + carry_len + 1);
+    if (carry_len > 0) memcpy(data + body, carry, carry_len);
+    body += carry_len;
+    free(carry);
+
+    CsvPartition *partition = malloc(sizeof(CsvPartition));
+    partition->csv.data = data;
+    partition->csv.size = (size_t)body;
+    partition->index.file_size = (long long)file_size;
+    partition->index.file_mtime = 0;
+    index_lines(&partition->index, data, body);
+
+    // O processo 0 começa no byte 0: sua primeira linha é o cabeçalho
+    if (rank == 0 && partition->index.num_lines > 0) {
+        partition->index.num_lines--;
+        memmove(partition->index.offsets, partition->index.offsets + 1, (partition->index.num_lines + 1) * sizeof(long long));
+    }
+
+    // Numeração global: linhas dos processos anteriores e total do arquivo
+    int local_lines = partition->index.num_lines;
+    partition->first_line = 0;
+    MPI_Exscan(&local_lines, &partition->first_line, 1, MPI_INT, MPI_SUM, comm);
+    if (rank == 0) partition->first_line = 0;  // MPI_Exscan não define o valor no processo 0
+    MPI_Allreduce(&local_lines, &partition->total_lines, 1, MPI_INT, MPI_SUM, comm);
+
+    return partition;
+}
+
+// Libera a memória da faixa
+void csv_partition_free(CsvPartition *partition) {
+    if (partition) {
+        free((void *)partition->csv.data);
+        free(partition->index.offsets);
+        free(partition);
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef CSV_PARTITION_H
+#define CSV_PARTITION_H
+
+// Inclusão das bibliotecas necessárias
+#include <mpi.h>            // Para a leitura coletiva (MPI-IO)
+#include "line_index.h"     // Para os offsets das linhas locais
+#include "song_source.h"    // Para MappedCsv (bytes das linhas locais)
+
+#define CSV_PARTITION_MAX_READ (1 << 30)  // Maior leitura por chamada (o contador do MPI é int)
+
+// Faixa do CSV pertencente a um processo. O arquivo é dividido em faixas de bytes
+// do mesmo tamanho, lidas juntas com MPI_File_read_at_all; a linha cortada no início
+// de cada faixa é enviada ao vizinho da esquerda, que fica com ela inteira.
+typedef struct {
+    MappedCsv csv;       // Bytes das linhas locais completas (em memória, não mapeados)
+    LineIndex index;     // Offsets das linhas locais, relativos a csv.data
+    int first_line;      // Índice global da primeira linha local (MPI_Exscan)
+    int total_lines;     // Número total de linhas de dados do arquivo (MPI_Allreduce)
+} CsvPartition;
+
+// Declarações das funções
+
+/**
+ * Lê a faixa deste processo do CSV (operação coletiva no comunicador). Dispensa o
+ * índice de linhas: o cabeçalho é descartado pelo processo 0 e as contagens são
+ * combinadas entre os processos.
+ * @param filename Caminho do arquivo CSV
+ * @param comm Comunicador MPI
+ * @return Ponteiro para CsvPartition alocado, ou NULL em todos se o arquivo não puder ser lido
+ */
+CsvPartition* csv_partition_read(const char *filename, MPI_Comm comm);
+
+/**
+ * Libera a memória da faixa
+ * @param partition Ponteiro para CsvPartition a ser liberado
+ */
+void csv_partition_free(CsvPartition *partition);
+
+#endif // CSV_PARTITION_H
@@ -0,0 +1,179 @@
+#include "incremental_state.h"
+#include <stdio.h>        // Para entrada e saída de arquivos
+#include <stdlib.h>       // Para funções de alocação de memória
+#include <string.h>       // Para memcmp e memcpy
+#include <fcntl.h>        // Para open
+#include <unistd.h>       // Para pread e close
+#include <sys/stat.h>     // Para obter o tamanho do CSV
+#include "count_codec.h"  // Para o formato compacto das contagens
+
+// Cabeçalho gravado no início do arquivo de estado
+typedef struct {
+    char magic[8];               // INCREMENTAL_STATE_MAGIC
+    uint64_t source_size;        // Tamanho do CSV processado
+    uint64_t processed_songs;    // Músicas incluídas nas contagens
+    uint64_t prefix_state;       // Estado FNV-1a de todo o trecho processado
+    int64_t sentiment_counts[3]; // Classificações somadas
+    uint64_t words_size;         // Bytes das contagens de palavras
+    uint64_t artists_size;       // Bytes das contagens de artistas
+} IncrementalStateHeader;
+
+// Continua o hash FNV-1a (sem finalização, como em count_table_hash) sobre csv[from, to)
+// e devolve o último byte do trecho. Qualquer alteração, mesmo sem mudar o tamanho, muda o hash
+static int extend_hash(const char *csv_filename, uint64_t from, uint64_t to, uint64_t *hash, int *last_byte) {
+    int fd = open(csv_filename, O_RDONLY);
+    if (fd < 0) return -1;
+
+    char *buffer = malloc(INCREMENTAL_HASH_BUFFER);
+    uint64_t h = *hash;
+    uint64_t done = from;
+    int last = '\n';
+    while (done < to) {
+        size_t want = (to - done < INCREMENTAL_HASH_BUFFER) ? (size_t)(to - done) : INCREMENTAL_HASH_BUFFER;
+        ssize_t n = pread(fd, buffer, want, (off_t)done);
+        if (n <= 0) break;
+        for (ssize_t i = 0; i < n; i++) {
+            h ^= (unsigned char)buffer[i];
+            h *= 1099511628211ULL;
+        }
+        last = (unsigned char)buffer[n - 1];
+        done += (uint64_t)n;
+    }
+    free(buffer);
+    close(fd);
+    if (done != to) return -1;
+
+    *hash = h;
+    *last_byte = last;
+    return 0;
+}
+
+// Cria um estado vazio
+IncrementalState* incremental_state_create(void) {
+    IncrementalState *state = calloc(1, sizeof(IncrementalState));
+    state->prefix_state = INCREMENTAL_HASH_BASIS;
+    return state;
+}
+
+// Carrega o estado e confere se o CSV atual é uma continuação do processado
+IncrementalState* incremental_state_load(const char *state_path, const char *csv_filename, const char **reason) {
+    FILE *file = fopen(state_path, "rb");
+    if (!file) {
+        *reason = "arquivo de estado ainda não existe";
+        return NULL;
+    }
+
+    IncrementalStateHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, INCREMENTAL_STATE_MAGIC, sizeof(header.magic)) != 0) {
+        fclose(file);
+        *reason = "arquivo de estado inválido";
+        return NULL;
+    }
+
+    IncrementalState *state = incremental_state_create();
+    state->source_size = header.source_size;
+    state->processed_songs = (int)header.processed_songs;
+    state->prefix_state = header.prefix_state;
+    for (int i = 0; i < 3; i++) {
+        state->sentiment_counts[i] = (int)header.sentiment_counts[i];
+    }
+    state->words_size = header.words_size;
+    state->artists_size = header.artists_size;
+    state->words = malloc(state->words_size > 0 ? state->words_size : 1);
+    state->artists = malloc(state->artists_size > 0 ? state->artists_size : 1);
+    int complete = fread(state->words, 1, state->words_size, file) == state->words_size &&
+                   fread(state->artists, 1, state->artists_size, file) == state->artists_size;
+    fclose(file);
+    if (!complete) {
+        incremental_state_free(state);
+        *reason = "arquivo de estado incompleto";
+        return NULL;
+    }
+
+    // O CSV atual precisa começar exatamente com o trecho já processado
+    struct stat st;
+    uint64_t hash = INCREMENTAL_HASH_BASIS;
+    int last_byte;
+    if (stat(csv_filename, &st) != 0 || (uint64_t)st.st_size < state->source_size) {
+        *reason = "o CSV diminuiu desde a última execução";
+    } else if (extend_hash(csv_filename, 0, state->source_size, &hash, &last_byte) != 0 ||
+               hash != state->prefix_state) {
+        *reason = "o conteúdo já processado do CSV mudou";
+    } else if ((uint64_t)st.st_size > state->source_size && last_byte != '\n') {
+        // A última linha processada não terminava em '\n': o acréscimo a alterou
+        *reason = "a última linha processada foi alterada";
+    } else {
+        return state;
+    }
+    incremental_state_free(state);
+    return NULL;
+}
+
+// Soma as contagens salvas em uma tabela
+void incremental_state_restore(const char *data, size_t size, CountTable *table) {
+    if (size > 0) {
+        count_codec_merge(table, data, size);
+    }
+}
+
+// Substitui as contagens salvas pelas de uma tabela
+void incremental_state_capture(char **data, size_t *size, const CountTable *table) {
+    free(*data);
+    *size = count_codec_table_size(table);
+    *data = malloc(*size > 0 ? *size : 1);
+    count_codec_encode_table(table, *data);
+}
+
+// Grava o estado em um arquivo temporário e o renomeia por cima do anterior
+int incremental_state_save(IncrementalState *state, const char *state_path, const char *csv_filename,
+                           uint64_t source_size, int processed_songs) {
+    IncrementalStateHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INCREMENTAL_STATE_MAGIC, sizeof(header.magic));
+    // O trecho [0, state->source_size) já foi conferido ao carregar: o hash só avança
+    header.prefix_state = state->prefix_state;
+    int last_byte;
+    if (source_size < state->source_size ||
+        extend_hash(csv_filename, state->source_size, source_size, &header.prefix_state, &last_byte) != 0) {
+        return -1;
+    }
+    header.source_size = source_size;
+    header.processed_songs = (uint64_t)processed_songs;
+    for (int i = 0; i < 3; i++) {
+        header.sentiment_counts[i] = state->sentiment_counts[i];
+    }
+    header.words_size = state->words_size;
+    header.artists_size = state->artists_size;
+
+    size_t len = strlen(state_path) + 5;
+    char *temp_path = malloc(len);
+    snprintf(temp_path, len, "%s.tmp", state_path);
+
+    int result = -1;
+    FILE *file = fopen(temp_path, "wb");
+    if (file) {
+        int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                 fwrite(state->words, 1, state->words_size, file) == state->words_size &&
+                 fwrite(state->artists, 1, state->artists_size, file) == state->artists_size;
+        if (fclose(file) == 0 && ok && rename(temp_path, state_path) == 0) {
+            state->source_size = source_size;
+            state->processed_songs = processed_songs;
+            state->prefix_state = header.prefix_state;
+            result = 0;
+        } else {
+            remove(temp_path);
+        }
+    }
+    free(temp_path);
+    return result;
+}
+
+// Libera a memória do estado
+void incremental_state_free(IncrementalState *state) {
+    if (state) {
+        free(state->words);
+        free(state->artists);
+        free(state);
+    }
+}
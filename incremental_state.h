@@ -0,0 +1,81 @@
+#ifndef INCREMENTAL_STATE_H
+#define INCREMENTAL_STATE_H
+
+// Inclusão das bibliotecas necessárias
+#include <stddef.h>         // Para size_t
+#include <stdint.h>         // Para inteiros de tamanho fixo
+#include "count_table.h"    // Para as tabelas de palavras e artistas
+
+#define INCREMENTAL_STATE_MAGIC "MIPSTAT3"      // Identificador do formato do arquivo de estado
+#define INCREMENTAL_HASH_BUFFER (1024 * 1024)   // Bytes lidos por vez ao calcular o hash do CSV
+#define INCREMENTAL_HASH_BASIS 1469598103934665603ULL   // Estado inicial do FNV-1a (trecho vazio)
+
+// Estado salvo entre execuções: contagens já somadas de todas as músicas processadas
+// e a identificação do trecho do CSV de onde vieram. Se o CSV só cresceu no final, a
+// próxima execução processa apenas as músicas novas e soma com este estado.
+typedef struct {
+    uint64_t source_size;        // Tamanho do CSV quando o estado foi salvo
+    int processed_songs;         // Músicas já incluídas nas contagens
+    uint64_t prefix_state;       // Estado FNV-1a (sem finalização) de todos os bytes do trecho processado:
+                                 // ao gravar, o hash continua só sobre os bytes acrescentados
+    int sentiment_counts[3];     // Classificações já somadas [Positivo, Neutro, Negativo]
+    char *words;                 // Contagens de palavras (formato de count_codec)
+    size_t words_size;
+    char *artists;               // Contagens de artistas (formato de count_codec)
+    size_t artists_size;
+} IncrementalState;
+
+// Declarações das funções
+
+/**
+ * Cria um estado vazio (primeira execução ou execução completa)
+ * @return Ponteiro para IncrementalState alocado
+ */
+IncrementalState* incremental_state_create(void);
+
+/**
+ * Carrega o estado e confere se o CSV atual é o mesmo, possivelmente com linhas
+ * acrescentadas no final (uma passada de leitura sobre o trecho já processado)
+ * @param state_path Caminho do arquivo de estado
+ * @param csv_filename Caminho do CSV
+ * @param reason Saída: motivo da recusa quando o retorno é NULL (para os logs)
+ * @return Estado carregado, ou NULL se não existir, estiver corrompido ou o CSV tiver mudado
+ */
+IncrementalState* incremental_state_load(const char *state_path, const char *csv_filename, const char **reason);
+
+/**
+ * Soma as contagens salvas em uma tabela
+ * @param data Contagens salvas (state->words ou state->artists)
+ * @param size Tamanho das contagens salvas
+ * @param table Tabela que recebe as contagens
+ */
+void incremental_state_restore(const char *data, size_t size, CountTable *table);
+
+/**
+ * Substitui as contagens salvas pelas de uma tabela (já com o estado anterior somado)
+ * @param data Contagens salvas (&state->words ou &state->artists)
+ * @param size Tamanho das contagens salvas
+ * @param table Tabela com as contagens completas
+ */
+void incremental_state_capture(char **data, size_t *size, const CountTable *table);
+
+/**
+ * Grava o estado (arquivo temporário + rename: uma falha não destrói o anterior). O hash
+ * do CSV continua a partir do trecho já conferido: só os bytes acrescentados são lidos
+ * @param state Estado com as contagens completas
+ * @param state_path Caminho do arquivo de estado
+ * @param csv_filename Caminho do CSV processado
+ * @param source_size Tamanho do CSV processado
+ * @param processed_songs Número de músicas incluídas nas contagens
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int incremental_state_save(IncrementalState *state, const char *state_path, const char *csv_filename,
+                           uint64_t source_size, int processed_songs);
+
+/**
+ * Libera a memória do estado
+ * @param state Ponteiro para IncrementalState a ser liberado
+ */
+void incremental_state_free(IncrementalState *state);
+
+#endif // INCREMENTAL_STATE_H
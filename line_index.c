@@ -0,0 +1,252 @@
+#include "line_index.h"
+#include <stdio.h>     // Para entrada e saída de arquivos
+#include <stdlib.h>    // Para funções de alocação de memória
+#include <string.h>    // Para memchr e manipulação de strings
+#include <sys/stat.h>  // Para obter tamanho e data de modificação do CSV
+
+#define LINE_INDEX_MAGIC "LIDX0001"       // Identificador do formato do arquivo de índice
+#define LINE_INDEX_READ_SIZE (4 * 1024 * 1024)  // Bloco de leitura ao construir o índice
+
+// Cabeçalho gravado no início do arquivo de índice
+typedef struct {
+    char magic[8];         // Identificador do formato
+    long long file_size;   // Tamanho do CSV indexado
+    long long file_mtime;  // Data de modificação do CSV indexado
+    long long num_lines;   // Número de linhas de dados
+} LineIndexHeader;
+
+// Monta o caminho do arquivo auxiliar (CSV + sufixo)
+static char* index_path(const char *filename) {
+    size_t len = strlen(filename) + strlen(LINE_INDEX_SUFFIX) + 1;
+    char *path = malloc(len);
+    snprintf(path, len, "%s%s", filename, LINE_INDEX_SUFFIX);
+    return path;
+}
+
+// Lê tamanho e data de modificação do CSV
+static int file_signature(const char *filename, long long *size, long long *mtime) {
+    struct stat st;
+    if (stat(filename, &st) != 0) return -1;
+    *size = (long long)st.st_size;
+    *mtime = (long long)st.st_mtime;
+    return 0;
+}
+
+// Adiciona um offset ao índice, dobrando a capacidade quando necessário
+static void push_offset(LineIndex *index, int *capacity, long long offset) {
+    if (index->num_lines + 1 >= *capacity) {
+        *capacity *= 2;
+        index->offsets = realloc(index->offsets, *capacity * sizeof(long long));
+    }
+    index->offsets[index->num_lines++] = offset;
+}
+
+// Percorre o CSV a partir da posição atual (offset 'base') e acrescenta ao índice o início
+// de cada linha de dados; devolve o offset do fim do arquivo
+static long long scan_lines(FILE *file, LineIndex *index, int *capacity, long long base, int *header_done) {
+    char *buffer = malloc(LINE_INDEX_READ_SIZE);
+    int line_open = 0;        // Se existe uma linha iniciada sem '\n' ainda
+    size_t n;
+
+    while ((n = fread(buffer, 1, LINE_INDEX_READ_SIZE, file)) > 0) {
+        char *p = buffer;
+        char *end = buffer + n;
+        while (p < end) {
+            // Marca o início de uma nova linha de dados
+            if (!line_open) {
+                if (*header_done) push_offset(index, capacity, base + (p - buffer));
+                line_open = 1;
+            }
+            char *newline = memchr(p, '\n', end - p);
+            if (!newline) {
+                p = end;
+                break;
+            }
+            // Linha terminada: a próxima começa após o '\n'
+            *header_done = 1;
+            line_open = 0;
+            p = newline + 1;
+        }
+        base += n;
+    }
+
+    free(buffer);
+    return base;
+}
+
+// Constrói o índice percorrendo o CSV uma única vez
+LineIndex* line_index_build(const char *filename) {
+    FILE *file = fopen(filename, "rb");
+    if (!file) return NULL;  // Retorna erro se não conseguir abrir o arquivo
+
+    LineIndex *index = malloc(sizeof(LineIndex));
+    int capacity = 1024;
+    index->offsets = malloc(capacity * sizeof(long long));
+    index->num_lines = 0;
+    file_signature(filename, &index->file_size, &index->file_mtime);
+
+    int header_done = 0;      // Se o cabeçalho já foi pulado
+    long long end = scan_lines(file, index, &capacity, 0, &header_done);
+    fclose(file);
+
+    // Arquivo vazio ou apenas com cabeçalho incompleto
+    if (!header_done) {
+        line_index_free(index);
+        return NULL;
+    }
+
+    // Offset final marca o fim da última linha
+    push_offset(index, &capacity, end);
+    index->num_lines--;
+    return index;
+}
+
+// Estende o índice salvo quando o CSV só cresceu: percorre apenas os bytes acrescentados
+LineIndex* line_index_extend(const char *filename, long long verified_size) {
+    long long size, mtime;
+    if (verified_size <= 0 || file_signature(filename, &size, &mtime) != 0 || size < verified_size) return NULL;
+
+    char *path = index_path(filename);
+    FILE *file = fopen(path, "rb");
+    free(path);
+    if (!file) return NULL;
+
+    // O índice salvo precisa cobrir exatamente o trecho conferido
+    LineIndexHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, LINE_INDEX_MAGIC, sizeof(header.magic)) != 0 ||
+        header.file_size != verified_size || header.num_lines < 0) {
+        fclose(file);
+        return NULL;
+    }
+
+    LineIndex *index = malloc(sizeof(LineIndex));
+    int capacity = (int)header.num_lines + 1024;
+    index->num_lines = (int)header.num_lines;
+    index->offsets = malloc(capacity * sizeof(long long));
+    int complete = fread(index->offsets, sizeof(long long), header.num_lines + 1, file) == (size_t)(header.num_lines + 1);
+    fclose(file);
+    if (!complete || index->offsets[index->num_lines] != verified_size) {
+        line_index_free(index);
+        return NULL;
+    }
+
+    // A última linha indexada precisa terminar em '\n'; o acréscimo começa numa linha nova
+    FILE *csv = fopen(filename, "rb");
+    if (!csv || fseeko(csv, (off_t)(verified_size - 1), SEEK_SET) != 0 || fgetc(csv) != '\n') {
+        if (csv) fclose(csv);
+        line_index_free(index);
+        return NULL;
+    }
+
+    // O sentinela do fim antigo vira o início da primeira linha nova
+    int header_done = 1;
+    long long end = scan_lines(csv, index, &capacity, verified_size, &header_done);
+    fclose(csv);
+    push_offset(index, &capacity, end);
+    index->num_lines--;
+    index->file_size = size;
+    index->file_mtime = mtime;
+    return index;
+}
+
+// Carrega o índice salvo ao lado do CSV, se ainda corresponder ao arquivo
+LineIndex* line_index_load(const char *filename) {
+    long long size, mtime;
+    if (file_signature(filename, &size, &mtime) != 0) return NULL;
+
+    char *path = index_path(filename);
+    FILE *file = fopen(path, "rb");
+    free(path);
+    if (!file) return NULL;
+
+    // Valida o cabeçalho contra o CSV atual
+    LineIndexHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, LINE_INDEX_MAGIC, sizeof(header.magic)) != 0 ||
+        header.file_size != size || header.file_mtime != mtime ||
+        header.num_lines < 0) {
+        fclose(file);
+        return NULL;
+    }
+
+    LineIndex *index = malloc(sizeof(LineIndex));
+    index->num_lines = (int)header.num_lines;
+    index->file_size = header.file_size;
+    index->file_mtime = header.file_mtime;
+    index->offsets = malloc((header.num_lines + 1) * sizeof(long long));
+
+    if (fread(index->offsets, sizeof(long long), header.num_lines + 1, file) != (size_t)(header.num_lines + 1)) {
+        fclose(file);
+        line_index_free(index);
+        return NULL;
+    }
+
+    fclose(file);
+    return index;
+}
+
+// Salva o índice no arquivo auxiliar ao lado do CSV
+int line_index_save(const LineIndex *index, const char *filename) {
+    char *path = index_path(filename);
+    FILE *file = fopen(path, "wb");
+    free(path);
+    if (!file) return -1;
+
+    LineIndexHeader header;
+    memcpy(header.magic, LINE_INDEX_MAGIC, sizeof(header.magic));
+    header.file_size = index->file_size;
+    header.file_mtime = index->file_mtime;
+    header.num_lines = index->num_lines;
+
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(index->offsets, sizeof(long long), index->num_lines + 1, file) == (size_t)(index->num_lines + 1);
+
+    if (fclose(file) != 0) ok = 0;
+    return ok ? 0 : -1;
+}
+
+// Obtém o índice no processo root e o transmite para todos os processos
+LineIndex* line_index_open_shared(const char *filename, long long verified_size, int root, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    LineIndex *index = NULL;
+    int num_lines = -1;
+
+    // Apenas o root toca no disco: usa o índice salvo, estende-o ou constrói um novo
+    if (rank == root) {
+        index = line_index_load(filename);
+        if (!index) {
+            index = line_index_extend(filename, verified_size);
+            if (!index) index = line_index_build(filename);
+            if (index && line_index_save(index, filename) != 0) {
+                fprintf(stderr, "Aviso: não foi possível salvar o índice de linhas de %s\n", filename);
+            }
+        }
+        if (index) num_lines = index->num_lines;
+    }
+
+    MPI_Bcast(&num_lines, 1, MPI_INT, root, comm);
+    if (num_lines < 0) return NULL;
+
+    // Os demais processos recebem os offsets prontos
+    if (rank != root) {
+        index = malloc(sizeof(LineIndex));
+        index->num_lines = num_lines;
+        index->offsets = malloc((num_lines + 1) * sizeof(long long));
+    }
+    MPI_Bcast(&index->file_size, 1, MPI_LONG_LONG, root, comm);
+    MPI_Bcast(&index->file_mtime, 1, MPI_LONG_LONG, root, comm);
+    MPI_Bcast(index->offsets, num_lines + 1, MPI_LONG_LONG, root, comm);
+
+    return index;
+}
+
+// Libera a memória do índice
+void line_index_free(LineIndex *index) {
+    if (index) {
+        free(index->offsets);  // Libera o vetor de offsets
+        free(index);           // Libera a estrutura principal
+    }
+}
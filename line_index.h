@@ -0,0 +1,68 @@
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+
+// Inclusão das bibliotecas necessárias
+#include <mpi.h>      // Para compartilhar o índice entre os processos
+
+// Sufixo do arquivo de índice salvo ao lado do CSV (ex: golden_music.csv.idx)
+#define LINE_INDEX_SUFFIX ".idx"
+
+// Estrutura do índice de linhas: posição em bytes de cada linha de dados do CSV
+typedef struct {
+    long long *offsets;   // offsets[i] = início da linha i; offsets[num_lines] = fim dos dados
+    int num_lines;        // Número de linhas de dados (sem o cabeçalho)
+    long long file_size;  // Tamanho do CSV quando o índice foi gerado
+    long long file_mtime; // Data de modificação do CSV quando o índice foi gerado
+} LineIndex;
+
+// Declarações das funções
+
+/**
+ * Constrói o índice percorrendo o CSV uma única vez
+ * @param filename Caminho do arquivo CSV
+ * @return Ponteiro para LineIndex alocado, ou NULL em caso de erro
+ */
+LineIndex* line_index_build(const char *filename);
+
+/**
+ * Estende o índice salvo quando o CSV só cresceu, percorrendo apenas os bytes acrescentados
+ * @param filename Caminho do arquivo CSV
+ * @param verified_size Bytes iniciais do CSV que se sabe não terem mudado (ex.: conferidos
+ *                      pelo estado incremental); o índice salvo precisa ter esse tamanho
+ * @return Ponteiro para LineIndex alocado, ou NULL se o índice salvo não servir
+ */
+LineIndex* line_index_extend(const char *filename, long long verified_size);
+
+/**
+ * Carrega o índice salvo ao lado do CSV, se ainda corresponder ao arquivo
+ * @param filename Caminho do arquivo CSV
+ * @return Ponteiro para LineIndex alocado, ou NULL se não existir ou estiver desatualizado
+ */
+LineIndex* line_index_load(const char *filename);
+
+/**
+ * Salva o índice no arquivo auxiliar ao lado do CSV
+ * @param index Índice a ser salvo
+ * @param filename Caminho do arquivo CSV
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int line_index_save(const LineIndex *index, const char *filename);
+
+/**
+ * Obtém o índice no processo root (carregando, estendendo ou construindo e salvando)
+ * e o transmite para todos os processos do comunicador
+ * @param filename Caminho do arquivo CSV
+ * @param verified_size Bytes iniciais do CSV já conferidos (0 = nenhum; só o root usa)
+ * @param root Processo responsável por ler o índice
+ * @param comm Comunicador MPI
+ * @return Índice em todos os processos, ou NULL em todos se o CSV não puder ser lido
+ */
+LineIndex* line_index_open_shared(const char *filename, long long verified_size, int root, MPI_Comm comm);
+
+/**
+ * Libera a memória do índice
+ * @param index Ponteiro para LineIndex a ser liberado
+ */
+void line_index_free(LineIndex *index);
+
+#endif // LINE_INDEX_H
@@ -2,33 +2,37 @@
 #include <stdio.h>    // Para entrada e saída padrão
 #include <stdlib.h>   // Para funções de alocação de memória
 #include <string.h>   // Para manipulação de strings
-#include <ctype.h>    // Para funções de caracteres (isalpha, etc.)
 #include <mpi.h>      // Para programação paralela com MPI
+#include <pthread.h>  // Para a classificação de sentimento em segundo plano
+#include <time.h>     // Para clock_gettime (a thread de fundo não chama MPI_Wtime)
 #include "ollama_client.h"  // Para comunicação com o modelo de IA Ollama
+#include "line_index.h"     // Para acesso direto às linhas do CSV por offset
+#include "song_source.h"    // Para visões sem cópia sobre o CSV mapeado em memória
+#include "analyzer.h"       // Para os analisadores de palavras, artistas e seleção do LLM
+#include "ngram_counter.h"  // Para a contagem de n-gramas na passada das palavras
+#include "song_stream.h"    // Para o modo contínuo (pipe ou arquivo que cresce)
+#include "sentiment_cache.h"  // Para reaproveitar classificações de execuções anteriores
+#include "chunk_scheduler.h"  // Para a distribuição dinâmica dos pedaços
+#include "worker_pool.h"      // Para as threads de análise dentro de cada processo
+#include "csv_partition.h"    // Para a leitura coletiva do CSV em faixas de bytes (MPI-IO)
+#include "song_store.h"       // Para o arquivo colunar gerado por song_ingest
+#include "incremental_state.h"  // Para processar só as músicas acrescentadas desde a última execução
+#include "phase_timer.h"        // Para medir cada fase com MPI_Wtime (--timings)
+#include "rank_stats.h"         // Para os tempos e contadores de cada processo e o resumo de desequilíbrio
+#include "sentiment_sample.h"   // Para a amostra estratificada com parada antecipada (--sample)
 
 // Definições de constantes para limites de tamanho
 #define MAX_LINE_LENGTH 100000    // Tamanho máximo de uma linha do CSV
-#define MAX_WORD_LENGTH 100      // Tamanho máximo de uma palavra
-#define MAX_ARTIST_LENGTH 200    // Tamanho máximo do nome do artista
 #define MAX_SONG_LENGTH 200      // Tamanho máximo do nome da música
 #define MAX_TEXT_LENGTH 10000     // Tamanho máximo do texto da letra
-#define MAX_WORDS 50000000          // Número máximo de palavras únicas
-#define MAX_ARTISTS 5000         // Número máximo de artistas únicos
 #define MAX_LLM_SONGS 200        // Número máximo de músicas para análise de sentimento
+#define DEFAULT_LLM_CONCURRENCY 4  // Requisições simultâneas ao Ollama por processo
+#define MAX_LLM_SERVERS 16       // Número máximo de servidores Ollama (--llm-url)
+#define MAX_LLM_BATCH 32         // Máximo de músicas por requisição (--llm-batch)
+#define MAX_THREADS 64           // Máximo de threads de análise por processo (--threads)
 #define IO_BUFFER_SIZE 1024 * 1024  // Buffer de 1MB para otimização de I/O
 #define LINES_PER_CHUNK 100      // Processar 100 linhas por vez
-
-// Estrutura para armazenar contagem de palavras
-typedef struct {
-    char word[MAX_WORD_LENGTH];  // A palavra em si
-    int count;                   // Quantas vezes a palavra aparece
-} WordCount;
-
-// Estrutura para armazenar contagem de artistas
-typedef struct {
-    char artist[MAX_ARTIST_LENGTH];  // Nome do artista
-    int song_count;                  // Quantas músicas o artista tem
-} ArtistCount;
+#define DEFAULT_INPUT_FILE "test_music.csv"  // CSV lido quando --input não é informado
 
 // Estrutura para armazenar dados de uma música
 typedef struct {
@@ -37,129 +41,640 @@ typedef struct {
     char text[MAX_TEXT_LENGTH];      // Letra da música
 } SongData;
 
+// Leitor de músicas: entrega visões de cada pedaço, apontando para o arquivo
+// mapeado (modo mmap) ou para um buffer de SongData reaproveitado (modo stdio)
+typedef struct {
+    const char* filename;     // Caminho do CSV
+    const LineIndex* index;   // Índice de linhas compartilhado
+    MappedCsv* mapped;        // Arquivo mapeado (NULL no modo stdio)
+    SongStore* store;         // Arquivo colunar (NULL nos modos CSV)
+    SongData* songs;          // Buffer de cópias usado apenas no modo stdio
+    SongView* views;          // Visões do último pedaço lido
+    int capacity;             // Capacidade dos buffers acima (em músicas)
+    int owns_mapping;         // 0 em cópias do leitor que compartilham o mapeamento
+    int first_line;           // Índice global da primeira linha do índice (faixa MPI-IO; 0 nos demais modos)
+} SongReader;
+
+// Opções de execução lidas da linha de comando
+typedef struct {
+    int use_mmap;  // Lê o CSV mapeado em memória, sem copiar os campos
+    int mpiio;     // Cada processo lê a sua faixa de bytes do CSV com MPI-IO coletivo
+    const char* input_path;  // CSV de entrada (--input)
+    const char* store_path;  // Arquivo colunar lido no lugar do CSV (NULL = usa o CSV)
+    const char* state_path;  // Arquivo de estado do modo incremental (NULL = execução completa)
+    int start_song;          // Primeira música a analisar (> 0 quando o estado salvo é reaproveitado)
+    int fused;     // Faz uma única passada alimentando todos os analisadores
+    int dynamic;   // Distribui os pedaços sob demanda, com tamanho adaptativo
+    int threads;   // Threads de análise por processo (1 = sem threads)
+    ReduceMode reduce_mode;  // Estratégia de redução das contagens entre processos
+    int ngram_n;             // Palavras por n-grama contado junto com as palavras (0 = desligado)
+    int llm_concurrency;     // Requisições simultâneas ao Ollama por processo
+    int llm_batch;           // Músicas por requisição ao Ollama (1 = uma por prompt)
+    const char* llm_urls[MAX_LLM_SERVERS];  // Servidores Ollama usados em rodízio (vazio = padrão)
+    int num_llm_urls;        // Número de servidores informados
+    const char* llm_cache_path;  // Arquivo do cache de classificações (NULL = sem cache)
+    const char* timings_path;    // JSON com o tempo de cada fase (NULL = não grava)
+    const char* stats_path;      // JSON com os tempos e contadores de cada processo (NULL = não grava)
+    int quiet;                   // 1 = sem as mensagens de progresso de cada processo e pedaço
+    int async_llm;               // 1 = classificação de sentimento numa thread de fundo, desde o início
+    int sample_max;              // Músicas da amostra estratificada para o LLM (0 = as primeiras MAX_LLM_SONGS)
+    double sample_ci;            // Largura alvo do intervalo de confiança de 95% que encerra a amostra
+    StreamConfig stream;         // Modo contínuo (stream.source NULL = lê o CSV inteiro)
+} RunOptions;
+
+// Sequência de pedaços de um processo: reservados no distribuidor dinâmico ou em rodízio fixo
+typedef struct {
+    ChunkScheduler* scheduler;  // Distribuidor dinâmico (NULL no rodízio fixo)
+    int next_line;              // Rodízio: início do próximo pedaço
+    int offset;                 // Somado às linhas do distribuidor dinâmico (modo incremental)
+    int stride;                 // Rodízio: distância entre pedaços consecutivos do processo
+    int total;                  // Número total de linhas
+} ChunkCursor;
+
+// Classificação de sentimento das músicas de um processo. run_sentiment_job não chama
+// MPI, então pode rodar numa thread de fundo enquanto a thread principal conta (--async-llm)
+typedef struct {
+    LlmSelector* selector;      // Músicas deste processo (já redistribuídas)
+    const RunOptions* options;  // Servidores, concorrência, lote e cache
+    int counts[3];              // [Positivo, Neutro, Negativo] deste processo
+    int from_cache;             // Músicas respondidas pelo cache
+    int missing;                // Músicas que não estavam no cache
+    int classified;             // Músicas classificadas pelo LLM
+    pthread_t thread;           // Thread de fundo (--async-llm)
+    int running;                // 1 = a thread foi criada e precisa de pthread_join
+    double started;             // Início da classificação (segundos, relógio monotônico)
+    double finished;            // Fim da classificação (segundos, relógio monotônico)
+} SentimentJob;
+
 // Protótipos das funções
-int count_csv_lines(const char* filename);  // Conta o número de linhas no arquivo CSV
-void read_file_chunk_optimized(const char* filename, int start_line, int num_lines, SongData* songs, int* actual_lines);  // Lê um pedaço do arquivo otimizado
-void count_words_io_optimized(const char* filename, int total_songs, WordCount* word_counts, int* num_words, int world_rank, int world_size);  // Conta palavras de forma paralela
-void count_artists_io_optimized(const char* filename, int total_songs, ArtistCount* artist_counts, int* num_artists, int world_rank, int world_size);  // Conta artistas de forma paralela
-void classify_sentiments_io_optimized(const char* filename, int total_songs, int* sentiment_counts, int world_rank, int world_size);  // Classifica sentimentos usando IA
-void print_results(WordCount* word_counts, int num_words, ArtistCount* artist_counts, int num_artists, int* sentiment_counts);  // Imprime os resultados finais
-int compare_word_counts(const void* a, const void* b);  // Função de comparação para ordenar palavras por frequência
-int compare_artist_counts(const void* a, const void* b);  // Função de comparação para ordenar artistas por número de músicas
+void parse_options(int argc, char* argv[], RunOptions* options, int world_rank);  // Lê as opções da linha de comando
+void read_file_chunk_optimized(const char* filename, const LineIndex* index, int start_line, int num_lines, SongData* songs, int* actual_lines);  // Lê um pedaço do arquivo otimizado
+void read_file_lines_optimized(const char* filename, const LineIndex* index, int* lines, int num_lines, SongData* songs, int* actual_lines);  // Lê linhas avulsas com um único arquivo aberto
+SongReader* open_song_reader(const char* filename, const LineIndex* index, int use_mmap);  // Abre o leitor de músicas no modo escolhido
+SongReader* open_partition_reader(const char* filename, CsvPartition* partition);  // Abre o leitor sobre a faixa lida com MPI-IO
+SongReader* open_store_reader(const char* filename, SongStore* store);  // Abre o leitor sobre o arquivo colunar
+SongReader* clone_song_reader(const SongReader* reader);  // Cria um segundo leitor com buffers próprios
+const SongView* read_song_chunk(SongReader* reader, int start_line, int num_lines, int* actual_lines);  // Lê um pedaço como visões
+const SongView* read_song_lines(SongReader* reader, int* lines, int num_lines, int* actual_lines);  // Lê músicas avulsas como visões
+void close_song_reader(SongReader* reader);  // Libera o leitor de músicas
+const SongView* read_counted_chunk(SongReader* reader, int start_line, int num_lines, int* actual_lines);  // Lê um pedaço registrando tempo de I/O, bytes e músicas
+int analyze_chunk(SongReader* reader, const RunOptions* options, int start_line, int num_lines, Analyzer* analyzers, int num_analyzers, int world_rank);  // Lê um pedaço e o entrega aos analisadores
+int next_pass_chunk(ChunkCursor* cursor, int* start_line, int* num_lines);  // Próximo pedaço deste processo
+void run_threaded_pass(SongReader* reader, const RunOptions* options, ChunkCursor* cursor, Analyzer* analyzers, int num_analyzers, int world_rank);  // Passada com threads e leitura sobreposta
+void run_analysis_pass(SongReader* reader, const RunOptions* options, int total_songs, Analyzer* analyzers, int num_analyzers, int world_rank, int world_size);  // Passada sobre o CSV alimentando os analisadores
+void count_words_io_optimized(SongReader* reader, const RunOptions* options, int total_songs, IncrementalState* state, NgramCounter* ngram_counter, NgramCount** ngram_counts, long long* num_ngrams, WordCount** word_counts, int* num_words, SketchBounds* bounds, int world_rank, int world_size);  // Conta palavras de forma paralela
+void count_artists_io_optimized(SongReader* reader, const RunOptions* options, int total_songs, IncrementalState* state, ArtistCount** artist_counts, int* num_artists, SketchBounds* bounds, int world_rank, int world_size);  // Conta artistas de forma paralela
+LlmSelector* select_llm_songs(SongReader* reader, const RunOptions* options, int total_songs, int world_rank);  // Lê as músicas enviadas ao LLM
+void classify_sentiments_io_optimized(SongReader* reader, const RunOptions* options, int total_songs, int* sentiment_counts, int world_rank, int world_size);  // Classifica sentimentos usando IA
+void classify_selected_sentiments(LlmSelector* selector, const RunOptions* options, int* sentiment_counts, int world_rank, int world_size);  // Classifica as músicas escolhidas pelo seletor
+void classify_sampled_sentiments(SongReader* reader, const RunOptions* options, int total_songs, int* sentiment_counts, int world_rank, int world_size);  // Classifica uma amostra estratificada até o IC atingir a largura alvo
+void run_sentiment_job(SentimentJob* job);  // Cache + LLM das músicas deste processo (sem MPI)
+void finish_sentiment_job(SentimentJob* job, int* sentiment_counts, int world_rank);  // Soma as classificações no processo 0
+SentimentJob* start_async_sentiments(SongReader* reader, const RunOptions* options, int total_songs, int world_rank, int world_size);  // Inicia a classificação numa thread de fundo
+void join_async_sentiments(SentimentJob* job, int* sentiment_counts, int world_rank);  // Espera a thread de fundo e soma as classificações
+void print_results(WordCount* word_counts, int num_words, const SketchBounds* word_bounds, ArtistCount* artist_counts, int num_artists, const SketchBounds* artist_bounds, int* sentiment_counts, NgramCount* ngram_counts, long long num_ngrams, int ngram_n);  // Imprime os resultados finais
 
 int main(int argc, char* argv[]) {
     int world_rank, world_size;  // Variáveis para identificar o processo atual e total de processos
     
-    // Inicializa o ambiente MPI (Message Passing Interface)
-    MPI_Init(&argc, &argv);
+    // Inicializa o ambiente MPI (Message Passing Interface). As threads de análise
+    // nunca chamam MPI: basta que a thread principal possa fazê-lo (FUNNELED)
+    int thread_support;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &thread_support);
+    ollama_global_init();  // libcurl é inicializado uma única vez por processo
     MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);  // Obtém o ID do processo atual (0, 1, 2, ...)
     MPI_Comm_size(MPI_COMM_WORLD, &world_size);  // Obtém o número total de processos
     
+    // Lê as opções de execução (todos os processos recebem os mesmos argumentos)
+    RunOptions options;
+    parse_options(argc, argv, &options, world_rank);
+    PhaseTimer timer;
+    phase_timer_start(&timer);
+    rank_stats_start();
+    if (options.threads > 1 && thread_support < MPI_THREAD_FUNNELED) {
+        if (world_rank == 0) {
+            printf("Aviso: a biblioteca MPI não suporta threads; usando --threads 1\n");
+        }
+        options.threads = 1;
+    }
+    if (options.async_llm && thread_support < MPI_THREAD_FUNNELED) {
+        if (world_rank == 0) {
+            printf("Aviso: a biblioteca MPI não suporta threads; a classificação de sentimento roda no fim\n");
+        }
+        options.async_llm = 0;
+    }
+    
+    // Modo contínuo: as músicas chegam por um pipe ou arquivo que cresce, sem contagem prévia de linhas
+    if (options.stream.source) {
+        if (world_rank == 0) {
+            printf("Programa de Análise de Música - Versão MPI (modo contínuo)\n");
+            printf("==================================================\n");
+            printf("Usando %d processos MPI\n", world_size);
+        }
+        long long streamed = song_stream_run(&options.stream, world_rank, world_size);
+        phase_timer_mark(&timer, "stream");
+        if (streamed >= 0) {
+            if (rank_stats_report(options.stats_path, 1, 0, MPI_COMM_WORLD) != 0) {
+                printf("Aviso: não foi possível gravar a instrumentação em %s\n", options.stats_path);
+            }
+            long long songs = streamed;
+            MPI_Bcast(&songs, 1, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
+            if (options.timings_path &&
+                phase_timer_write_json(&timer, options.timings_path, argc, argv, (long)songs, 0, MPI_COMM_WORLD) != 0) {
+                printf("Aviso: não foi possível gravar os tempos em %s\n", options.timings_path);
+            }
+        }
+        ollama_global_cleanup();
+        MPI_Finalize();
+        return streamed >= 0 ? 0 : 1;
+    }
+    
     // Apenas o processo 0 (mestre) imprime informações iniciais
     if (world_rank == 0) {
         printf("Programa de Análise de Música - Versão MPI\n");
         printf("==================================================\n");
         printf("Usando %d processos MPI\n", world_size);
+        printf("Arquivo de entrada: %s\n", options.store_path ? options.store_path : options.input_path);
         printf("Tamanho do buffer I/O: %d bytes\n", IO_BUFFER_SIZE);
         printf("Linhas por pedaço: %d\n", LINES_PER_CHUNK);
-        printf("Máximo de músicas para LLM: %d (para economizar tempo e memória)\n\n", MAX_LLM_SONGS);
+        printf("Modo de leitura: %s\n", options.store_path ? "arquivo colunar (mmap, acesso direto por índice)" :
+                                        options.mpiio ? "MPI-IO coletivo (uma faixa de bytes por processo)" :
+                                        options.use_mmap ? "mmap (visões sem cópia)" : "stdio (cópia para SongData)");
+        printf("Modo de análise: %s\n", options.fused ? "passada única (todos os analisadores)" : "uma passada por análise");
+        printf("Distribuição dos pedaços: %s\n", options.dynamic ? "dinâmica (contador MPI_Fetch_and_op, tamanho adaptativo)" : "rodízio fixo");
+        printf("Threads de análise por processo: %d%s\n", options.threads, options.threads > 1 ? " (leitura do próximo pedaço sobreposta à análise)" : "");
+        printf("Redução: %s\n", options.reduce_mode == REDUCE_SHUFFLE ? "particionada por hash (MPI_Alltoallv)" :
+                                 options.reduce_mode == REDUCE_TPUT ? "top-K exato por limiar (TPUT)" :
+                                 options.reduce_mode == REDUCE_SKETCH ? "aproximada (Count-Min + HyperLogLog, MPI_Reduce)" : "junção serial no processo 0");
+        if (options.sample_max) {
+            printf("Amostra para o LLM: estratificada, até %d músicas, parada com IC de 95%% de largura %.3f\n",
+                   options.sample_max, options.sample_ci);
+        } else {
+            printf("Máximo de músicas para LLM: %d (para economizar tempo e memória)\n", MAX_LLM_SONGS);
+        }
+        printf("Requisições simultâneas ao LLM por processo: %d (%d servidor(es), %d música(s) por requisição)\n",
+               options.llm_concurrency, options.num_llm_urls > 0 ? options.num_llm_urls : 1, options.llm_batch);
+        printf("Cache de sentimentos: %s\n", options.llm_cache_path ? options.llm_cache_path : "desativado");
+        printf("Classificação de sentimento: %s\n\n", options.async_llm ? "thread de fundo desde o início (sobreposta às contagens)" : "depois das contagens");
     }
     
-    // Obtém o número total de músicas (apenas o processo 0)
-    int total_songs = 0;
-    if (world_rank == 0) {
-        total_songs = count_csv_lines("test_music.csv");
-        if (total_songs <= 0) {
-            printf("Erro: Não foi possível ler o arquivo CSV ou o arquivo está vazio\n");
-            MPI_Abort(MPI_COMM_WORLD, 1);  // Termina todos os processos se houver erro
+    // Obtém o índice de linhas do CSV (carregado ou construído pelo processo 0)
+    // e o compartilha com todos, junto com o número total de músicas. No modo MPI-IO
+    // cada processo lê apenas a sua faixa e as contagens de linhas são combinadas
+    const char* csv_filename = options.input_path;
+    // Modo incremental: o processo 0 confere o estado salvo antes do índice, que então só
+    // precisa percorrer os bytes acrescentados
+    IncrementalState* state = NULL;
+    int resumed = 0;
+    if (options.state_path && world_rank == 0) {
+        const char* reason = NULL;
+        state = incremental_state_load(options.state_path, csv_filename, &reason);
+        resumed = state != NULL;
+        if (!state) {
+            printf("Estado incremental: execução completa (%s)\n", reason);
+            state = incremental_state_create();
+        }
+    }
+    
+    LineIndex* line_index = NULL;
+    CsvPartition* partition = NULL;
+    SongStore* store = NULL;
+    int total_songs;
+    if (options.store_path) {
+        // Arquivo colunar: o total vem do cabeçalho, sem índice nem separação de campos
+        store = song_store_open(options.store_path);
+        total_songs = store ? store->num_records : 0;
+    } else if (options.mpiio) {
+        partition = csv_partition_read(csv_filename, MPI_COMM_WORLD);
+        total_songs = partition ? partition->total_lines : 0;
+    } else {
+        line_index = line_index_open_shared(csv_filename, resumed ? (long long)state->source_size : 0, 0, MPI_COMM_WORLD);
+        total_songs = line_index ? line_index->num_lines : 0;
+    }
+    if (total_songs <= 0) {
+        if (world_rank == 0) {
+            if (options.store_path) {
+                printf("Erro: Não foi possível ler o arquivo colunar %s (gere-o com ./song_ingest)\n", options.store_path);
+            } else {
+                printf("Erro: Não foi possível ler o arquivo CSV ou o arquivo está vazio\n");
+            }
         }
+        MPI_Abort(MPI_COMM_WORLD, 1);  // Termina todos os processos se houver erro
+    }
+    if (world_rank == 0) {
         printf("Encontradas %d músicas no arquivo CSV\n", total_songs);
     }
     
-    // Transmite o número total de músicas para todos os processos
-    MPI_Bcast(&total_songs, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    // Todos os processos pulam as músicas já contadas
+    if (options.state_path) {
+        if (resumed && total_songs < state->processed_songs) {
+            printf("Estado incremental: execução completa (o CSV tem menos músicas que as já processadas)\n");
+            incremental_state_free(state);
+            state = incremental_state_create();
+            resumed = 0;
+        }
+        if (resumed) {
+            printf("Estado incremental: %d músicas já processadas, analisando apenas as %d novas\n",
+                   state->processed_songs, total_songs - state->processed_songs);
+            options.start_song = state->processed_songs;
+        }
+        MPI_Bcast(&options.start_song, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    }
+    
+    // Abre o leitor de músicas no modo escolhido
+    SongReader* reader = store ? open_store_reader(options.store_path, store) :
+                         options.mpiio ? open_partition_reader(csv_filename, partition) :
+                                         open_song_reader(csv_filename, line_index, options.use_mmap);
+    if (!reader) {
+        printf("Erro: Processo %d não conseguiu mapear o arquivo CSV\n", world_rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    phase_timer_mark(&timer, "open_input");
+    
+    // Classificação de sentimento em segundo plano: as músicas são escolhidas e
+    // redistribuídas agora e a rede trabalha enquanto a thread principal conta
+    SentimentJob* sentiment_job = NULL;
+    if (options.async_llm) {
+        sentiment_job = start_async_sentiments(reader, &options, total_songs, world_rank, world_size);
+        phase_timer_mark(&timer, "start_sentiment");
+    }
     
-    // Arrays para armazenar os resultados
+    // Arrays para armazenar os resultados (alocados pelo processo 0 na redução, do tamanho exato)
     WordCount* word_counts = NULL;  // Array para contagem de palavras
     int num_words = 0;              // Número de palavras únicas encontradas
     ArtistCount* artist_counts = NULL;  // Array para contagem de artistas
     int num_artists = 0;            // Número de artistas únicos encontrados
     int sentiment_counts[3] = {0, 0, 0}; // [Positivo, Neutro, Negativo]
+    SketchBounds word_bounds, artist_bounds;  // Limites de erro do modo aproximado (--approx)
+    NgramCount* ngram_counts = NULL;  // Top-K de n-gramas (--ngrams)
+    long long num_ngrams = 0;         // Número de n-gramas distintos
+    NgramCounter* ngram_counter = options.ngram_n ? ngram_counter_create(options.ngram_n) : NULL;
     
-    // Apenas o processo 0 aloca memória para os resultados finais
-    if (world_rank == 0) {
-        word_counts = (WordCount*)malloc(MAX_WORDS * sizeof(WordCount));
-        artist_counts = (ArtistCount*)malloc(MAX_ARTISTS * sizeof(ArtistCount));
+    if (options.fused) {
+        // Passada única: cada música é lida e separada uma vez e entregue a todos os analisadores
+        if (world_rank == 0) {
+            printf("\nPassada Única - Palavras, Artistas e Seleção para o LLM\n");
+            printf("=======================================================\n");
+        }
+        WordCounter* word_counter = word_counter_create(options.reduce_mode == REDUCE_SKETCH);
+        ArtistCounter* artist_counter = artist_counter_create(options.reduce_mode == REDUCE_SKETCH);
+        LlmSelector* selector = (sentiment_job || options.sample_max) ? NULL : llm_selector_create(MAX_LLM_SONGS);
+        Analyzer analyzers[4] = {
+            word_counter_analyzer(word_counter),
+            artist_counter_analyzer(artist_counter)
+        };
+        int num_analyzers = 2;
+        if (selector) analyzers[num_analyzers++] = llm_selector_analyzer(selector);
+        if (ngram_counter) analyzers[num_analyzers++] = ngram_counter_analyzer(ngram_counter);
+        run_analysis_pass(reader, &options, total_songs, analyzers, num_analyzers, world_rank, world_size);
+        phase_timer_mark(&timer, "fused_pass");
+        rank_stats_add(STAT_TOKENS, word_counter_tokens(word_counter));
+        rank_stats_add(STAT_WORD_KEYS, word_counter_keys(word_counter));
+        rank_stats_add(STAT_ARTIST_KEYS, artist_counter_keys(artist_counter));
+        
+        if (world_rank == 0) {
+            printf("\n1. Análise de Contagem de Palavras - \n");
+            printf("=======================================================\n");
+        }
+        rank_stats_enter(STAT_MERGE);
+        if (state && world_rank == 0) incremental_state_restore(state->words, state->words_size, word_counter->table);
+        rank_stats_enter(STAT_COMM);
+        word_counter_reduce(word_counter, options.reduce_mode, &word_counts, &num_words, &word_bounds, world_rank);
+        rank_stats_enter(STAT_OTHER);
+        if (state && world_rank == 0) incremental_state_capture(&state->words, &state->words_size, word_counter->table);
+        phase_timer_mark(&timer, "reduce_words");
+        
+        if (ngram_counter) {
+            rank_stats_enter(STAT_COMM);
+            ngram_counter_reduce(ngram_counter, &ngram_counts, &num_ngrams, world_rank, world_size);
+            rank_stats_enter(STAT_OTHER);
+            phase_timer_mark(&timer, "reduce_ngrams");
+        }
+        
+        if (world_rank == 0) {
+            printf("\n2. Análise de Artistas - \n");
+            printf("===============================================\n");
+        }
+        rank_stats_enter(STAT_MERGE);
+        if (state && world_rank == 0) incremental_state_restore(state->artists, state->artists_size, artist_counter->table);
+        rank_stats_enter(STAT_COMM);
+        artist_counter_reduce(artist_counter, options.reduce_mode, &artist_counts, &num_artists, &artist_bounds, world_rank);
+        rank_stats_enter(STAT_OTHER);
+        if (state && world_rank == 0) incremental_state_capture(&state->artists, &state->artists_size, artist_counter->table);
+        phase_timer_mark(&timer, "reduce_artists");
+        
+        if (world_rank == 0) {
+            printf("\n3. Classificação de Sentimento - \n");
+            printf("========================================================\n");
+        }
+        if (sentiment_job) {
+            join_async_sentiments(sentiment_job, sentiment_counts, world_rank);
+        } else if (options.sample_max) {
+            classify_sampled_sentiments(reader, &options, total_songs, sentiment_counts, world_rank, world_size);
+        } else {
+            classify_selected_sentiments(selector, &options, sentiment_counts, world_rank, world_size);
+        }
+        phase_timer_mark(&timer, "sentiment");
+        
+        word_counter_free(word_counter);
+        artist_counter_free(artist_counter);
+        llm_selector_free(selector);
+    } else {
+        // 1. Contagem de Palavras - Análise paralela
+        if (world_rank == 0) {
+            printf("\n1. Análise de Contagem de Palavras - \n");
+            printf("=======================================================\n");
+        }
+        count_words_io_optimized(reader, &options, total_songs, state, ngram_counter, &ngram_counts, &num_ngrams, &word_counts, &num_words, &word_bounds, world_rank, world_size);
+        phase_timer_mark(&timer, "words");
+        
+        // 2. Análise de Artistas - Contagem paralela
+        if (world_rank == 0) {
+            printf("\n2. Análise de Artistas - \n");
+            printf("===============================================\n");
+        }
+        count_artists_io_optimized(reader, &options, total_songs, state, &artist_counts, &num_artists, &artist_bounds, world_rank, world_size);
+        phase_timer_mark(&timer, "artists");
+        
+        // 3. Classificação de Sentimento - Usando IA
+        if (world_rank == 0) {
+            printf("\n3. Classificação de Sentimento - \n");
+            printf("========================================================\n");
+        }
+        if (sentiment_job) {
+            join_async_sentiments(sentiment_job, sentiment_counts, world_rank);
+        } else {
+            classify_sentiments_io_optimized(reader, &options, total_songs, sentiment_counts, world_rank, world_size);
+        }
+        phase_timer_mark(&timer, "sentiment");
     }
     
-    // 1. Contagem de Palavras - Análise paralela
-    if (world_rank == 0) {
-        printf("\n1. Análise de Contagem de Palavras - \n");
-        printf("=======================================================\n");
+    // Soma as classificações salvas e grava o novo estado (apenas o processo 0)
+    if (state && world_rank == 0) {
+        for (int i = 0; i < 3; i++) {
+            sentiment_counts[i] += state->sentiment_counts[i];
+            state->sentiment_counts[i] = sentiment_counts[i];
+        }
+        uint64_t source_size = (uint64_t)(line_index ? line_index->file_size : partition->index.file_size);
+        if (incremental_state_save(state, options.state_path, csv_filename, source_size, total_songs) != 0) {
+            printf("Aviso: não foi possível gravar o estado incremental em %s\n", options.state_path);
+        }
     }
-    count_words_io_optimized("test_music.csv", total_songs, word_counts, &num_words, world_rank, world_size);
     
-    // 2. Análise de Artistas - Contagem paralela
-    if (world_rank == 0) {
-        printf("\n2. Análise de Artistas - \n");
-        printf("===============================================\n");
-    }
-    count_artists_io_optimized("test_music.csv", total_songs, artist_counts, &num_artists, world_rank, world_size);
+    phase_timer_mark(&timer, "finish");
     
-    // 3. Classificação de Sentimento - Usando IA
-    if (world_rank == 0) {
-        printf("\n3. Classificação de Sentimento - \n");
-        printf("========================================================\n");
+    // Resumo dos tempos e contadores de cada processo (desequilíbrio e caminho crítico)
+    if (rank_stats_report(options.stats_path, 1, 0, MPI_COMM_WORLD) != 0) {
+        printf("Aviso: não foi possível gravar a instrumentação em %s\n", options.stats_path);
     }
-    classify_sentiments_io_optimized("test_music.csv", total_songs, sentiment_counts, world_rank, world_size);
     
     // Imprime os resultados (apenas o processo 0)
     if (world_rank == 0) {
-        print_results(word_counts, num_words, artist_counts, num_artists, sentiment_counts);
+        int approximate = options.reduce_mode == REDUCE_SKETCH;
+        print_results(word_counts, num_words, approximate ? &word_bounds : NULL,
+                      artist_counts, num_artists, approximate ? &artist_bounds : NULL, sentiment_counts,
+                      ngram_counts, num_ngrams, options.ngram_n);
+    }
+    
+    // Tempos das fases (mínimo, média e máximo entre os processos) para os benchmarks
+    if (options.timings_path &&
+        phase_timer_write_json(&timer, options.timings_path, argc, argv, total_songs, 0, MPI_COMM_WORLD) != 0) {
+        printf("Aviso: não foi possível gravar os tempos em %s\n", options.timings_path);
     }
     
     // Limpeza da memória
     if (world_rank == 0) {
         free(word_counts);
         free(artist_counts);
+        free(ngram_counts);
     }
+    ngram_counter_free(ngram_counter);
+    close_song_reader(reader);
+    line_index_free(line_index);
+    csv_partition_free(partition);
+    incremental_state_free(state);
     
     // Finaliza o ambiente MPI
+    ollama_global_cleanup();
     MPI_Finalize();
     return 0;
 }
 
-// Função para contar o número de linhas no arquivo CSV
-int count_csv_lines(const char* filename) {
-    FILE* file = fopen(filename, "r");
-    if (!file) return -1;  // Retorna erro se não conseguir abrir o arquivo
+// Função para ler as opções da linha de comando
+void parse_options(int argc, char* argv[], RunOptions* options, int world_rank) {
+    options->use_mmap = 0;
+    options->mpiio = 0;
+    options->input_path = DEFAULT_INPUT_FILE;
+    options->store_path = NULL;
+    options->state_path = NULL;
+    options->start_song = 0;
+    options->fused = 0;
+    options->dynamic = 0;
+    options->threads = 1;
+    options->reduce_mode = REDUCE_GATHER;
+    options->ngram_n = 0;
+    options->llm_concurrency = DEFAULT_LLM_CONCURRENCY;
+    options->llm_batch = 1;
+    options->num_llm_urls = 0;
+    options->llm_cache_path = SENTIMENT_CACHE_DEFAULT_PATH;
+    options->timings_path = NULL;
+    options->stats_path = NULL;
+    options->quiet = 0;
+    options->async_llm = 0;
+    options->sample_max = 0;
+    options->sample_ci = SAMPLE_DEFAULT_CI_WIDTH;
+    options->stream.source = NULL;
+    options->stream.follow = 0;
+    options->stream.idle_seconds = 0.0;
+    options->stream.snapshot_interval = STREAM_DEFAULT_INTERVAL;
+    options->stream.snapshot_path = NULL;
     
-    // Otimiza I/O com buffer grande para melhor performance
-    char* buffer = (char*)malloc(IO_BUFFER_SIZE);
-    setvbuf(file, buffer, _IOFBF, IO_BUFFER_SIZE);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--mmap") == 0) {
+            options->use_mmap = 1;
+        } else if (strcmp(argv[i], "--mpiio") == 0) {
+            options->mpiio = 1;
+        } else if (strcmp(argv[i], "--input") == 0 && i + 1 < argc) {
+            options->input_path = argv[++i];
+        } else if (strcmp(argv[i], "--store") == 0 && i + 1 < argc) {
+            options->store_path = argv[++i];
+        } else if (strcmp(argv[i], "--state") == 0 && i + 1 < argc) {
+            options->state_path = argv[++i];
+        } else if (strcmp(argv[i], "--fused") == 0) {
+            options->fused = 1;
+        } else if (strcmp(argv[i], "--dynamic") == 0) {
+            options->dynamic = 1;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0 && atoi(argv[i + 1]) <= MAX_THREADS) {
+            options->threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--shuffle") == 0) {
+            options->reduce_mode = REDUCE_SHUFFLE;
+        } else if (strcmp(argv[i], "--topk-tput") == 0) {
+            options->reduce_mode = REDUCE_TPUT;
+        } else if (strcmp(argv[i], "--approx") == 0) {
+            options->reduce_mode = REDUCE_SKETCH;
+        } else if (strcmp(argv[i], "--ngrams") == 0 && i + 1 < argc && atoi(argv[i + 1]) >= NGRAM_MIN_N && atoi(argv[i + 1]) <= NGRAM_MAX_N) {
+            options->ngram_n = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--llm-concurrency") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            options->llm_concurrency = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--llm-batch") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0 && atoi(argv[i + 1]) <= MAX_LLM_BATCH) {
+            options->llm_batch = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--llm-url") == 0 && i + 1 < argc && options->num_llm_urls < MAX_LLM_SERVERS) {
+            options->llm_urls[options->num_llm_urls++] = argv[++i];
+        } else if (strcmp(argv[i], "--llm-cache") == 0 && i + 1 < argc) {
+            options->llm_cache_path = argv[++i];
+        } else if (strcmp(argv[i], "--no-llm-cache") == 0) {
+            options->llm_cache_path = NULL;
+        } else if (strcmp(argv[i], "--timings") == 0 && i + 1 < argc) {
+            options->timings_path = argv[++i];
+        } else if (strcmp(argv[i], "--stats") == 0 && i + 1 < argc) {
+            options->stats_path = argv[++i];
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            options->quiet = 1;
+        } else if (strcmp(argv[i], "--async-llm") == 0) {
+            options->async_llm = 1;
+        } else if (strcmp(argv[i], "--sample") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            options->sample_max = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--sample-ci") == 0 && i + 1 < argc && atof(argv[i + 1]) > 0.0 && atof(argv[i + 1]) < 1.0) {
+            options->sample_ci = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--stream") == 0 && i + 1 < argc) {
+            options->stream.source = argv[++i];
+        } else if (strcmp(argv[i], "--follow") == 0) {
+            options->stream.follow = 1;
+        } else if (strcmp(argv[i], "--stream-idle") == 0 && i + 1 < argc && atof(argv[i + 1]) > 0.0) {
+            options->stream.idle_seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--snapshot-interval") == 0 && i + 1 < argc && atof(argv[i + 1]) > 0.0) {
+            options->stream.snapshot_interval = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) {
+            options->stream.snapshot_path = argv[++i];
+        } else {
+            if (world_rank == 0) {
+                printf("Erro: opção desconhecida '%s'\n", argv[i]);
+                printf("Uso: %s [--input FILE] [--mmap | --mpiio | --store FILE] [--state FILE] [--fused] [--dynamic] [--threads N] [--shuffle | --topk-tput | --approx] [--ngrams N] [--llm-concurrency N] [--llm-batch N] [--llm-url URL]... [--llm-cache FILE | --no-llm-cache] [--async-llm] [--sample N [--sample-ci W]] [--timings FILE] [--stats FILE] [--quiet] [--stream FILE|- [--follow] [--stream-idle S] [--snapshot-interval S] [--snapshot FILE]]\n", argv[0]);
+            }
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
     
-    char line[MAX_LINE_LENGTH];
-    int count = 0;
+    // O modo contínuo não tem arquivo inteiro: sem índice, faixas, estado nem sentimento
+    if (options->stream.source && (options->use_mmap || options->mpiio || options->store_path || options->state_path ||
+                                   options->fused || options->dynamic || options->threads > 1 ||
+                                   options->reduce_mode != REDUCE_GATHER || options->ngram_n ||
+                                   options->async_llm || options->sample_max)) {
+        if (world_rank == 0) {
+            printf("Aviso: com --stream as opções de leitura, distribuição, redução, --state, --ngrams, --async-llm e --sample são ignoradas\n");
+        }
+        // Zeradas aqui para que os avisos de combinação abaixo não as citem de novo
+        options->async_llm = 0;
+        options->sample_max = 0;
+    }
     
-    // Pula o cabeçalho do CSV (primeira linha)
-    if (fgets(line, sizeof(line), file) == NULL) {
-        fclose(file);
-        free(buffer);
-        return -1;
+    // O arquivo colunar já é mapeado e acessado por índice: dispensa a leitura do CSV
+    if (options->store_path && options->mpiio) {
+        if (world_rank == 0) {
+            printf("Aviso: --mpiio é ignorado com --store\n");
+        }
+        options->mpiio = 0;
     }
     
-    // Conta as linhas restantes (dados das músicas)
-    while (fgets(line, sizeof(line), file)) {
-        count++;
+    // O estado incremental identifica o CSV pelos seus bytes; o arquivo colunar é regerado a cada conversão
+    if (options->state_path && options->store_path) {
+        if (world_rank == 0) {
+            printf("Aviso: --state é ignorado com --store\n");
+        }
+        options->state_path = NULL;
     }
     
-    fclose(file);
-    free(buffer);
-    return count;
+    // A amostra estima proporções do arquivo inteiro: não se soma às classificações salvas
+    if (options->state_path && options->sample_max) {
+        if (world_rank == 0) {
+            printf("Aviso: --sample é ignorado com --state\n");
+        }
+        options->sample_max = 0;
+    }
+    
+    // A parada antecipada depende de MPI_Allreduce a cada rodada: fica na thread principal
+    if (options->sample_max && options->async_llm) {
+        if (world_rank == 0) {
+            printf("Aviso: --async-llm é ignorado com --sample (a amostra é classificada depois das contagens)\n");
+        }
+        options->async_llm = 0;
+    }
+    
+    // O estado incremental não guarda os n-gramas: só as músicas novas seriam contadas
+    if (options->state_path && options->ngram_n) {
+        if (world_rank == 0) {
+            printf("Aviso: --ngrams é ignorado com --state\n");
+        }
+        options->ngram_n = 0;
+    }
+    
+    // O estado incremental guarda contagens exatas: não combina com os sketches
+    if (options->state_path && options->reduce_mode == REDUCE_SKETCH) {
+        if (world_rank == 0) {
+            printf("Aviso: --state é ignorado com --approx\n");
+        }
+        options->state_path = NULL;
+    }
+    
+    // Para salvar as contagens completas o processo 0 precisa da tabela inteira (junção serial)
+    if (options->state_path && options->reduce_mode != REDUCE_GATHER) {
+        if (world_rank == 0) {
+            printf("Aviso: --state usa a junção serial no processo 0 (--shuffle/--topk-tput ignorados)\n");
+        }
+        options->reduce_mode = REDUCE_GATHER;
+    }
+    
+    // No modo MPI-IO cada processo já tem as suas linhas em memória: não há pedaços a disputar
+    if (options->mpiio && options->dynamic) {
+        if (world_rank == 0) {
+            printf("Aviso: --dynamic é ignorado com --mpiio (cada processo analisa a faixa que leu)\n");
+        }
+        options->dynamic = 0;
+    }
+}
+
+// Separa uma linha "artista|música|letra" (modificada no lugar) em uma SongData
+// Retorna 1 se a linha tem os dois separadores, 0 caso contrário
+static int parse_song_line(char* line, SongData* song) {
+    // Parsing rápido do CSV - encontra delimitadores manualmente
+    char* artist_start = line;  // Início do nome do artista
+    char* song_start = strchr(line, '|');  // Procura o primeiro separador
+    if (!song_start) return 0;  // Linha inválida se não encontrar o separador
+    *song_start++ = '\0';  // Termina a string do artista
+    
+    char* text_start = strchr(song_start, '|');  // Procura o segundo separador
+    if (!text_start) return 0;  // Linha inválida se não encontrar o separador
+    *text_start++ = '\0';  // Termina a string da música
+    
+    // Remove quebra de linha do texto
+    char* newline = strchr(text_start, '\n');
+    if (newline) *newline = '\0';
+    
+    // Copia para a estrutura com verificação de limites
+    int artist_len = strlen(artist_start);
+    int song_len = strlen(song_start);
+    int text_len = strlen(text_start);
+    
+    // Calcula o tamanho a copiar respeitando os limites máximos
+    int copy_artist_len = (artist_len < MAX_ARTIST_LENGTH - 1) ? artist_len : MAX_ARTIST_LENGTH - 1;
+    int copy_song_len = (song_len < MAX_SONG_LENGTH - 1) ? song_len : MAX_SONG_LENGTH - 1;
+    int copy_text_len = (text_len < MAX_TEXT_LENGTH - 1) ? text_len : MAX_TEXT_LENGTH - 1;
+    
+    // Copia os dados para a estrutura
+    strncpy(song->artist, artist_start, copy_artist_len);
+    song->artist[copy_artist_len] = '\0';
+    
+    strncpy(song->song, song_start, copy_song_len);
+    song->song[copy_song_len] = '\0';
+    
+    strncpy(song->text, text_start, copy_text_len);
+    song->text[copy_text_len] = '\0';
+    
+    return 1;
 }
 
 // Função para ler um pedaço do arquivo CSV de forma otimizada
-void read_file_chunk_optimized(const char* filename, int start_line, int num_lines, SongData* songs, int* actual_lines) {
+void read_file_chunk_optimized(const char* filename, const LineIndex* index, int start_line, int num_lines, SongData* songs, int* actual_lines) {
     FILE* file = fopen(filename, "r");
     if (!file) {
         *actual_lines = 0;
@@ -171,59 +686,19 @@ void read_file_chunk_optimized(const char* filename, int start_line, int num_lin
     setvbuf(file, buffer, _IOFBF, IO_BUFFER_SIZE);
     
     char line[MAX_LINE_LENGTH];
-    int current_line = 0;
     int count = 0;
     
-    // Pula o cabeçalho do CSV
-    if (fgets(line, sizeof(line), file) == NULL) {
+    // Vai direto ao início da linha desejada usando o índice (sem reler as anteriores)
+    if (start_line >= index->num_lines || fseeko(file, (off_t)index->offsets[start_line], SEEK_SET) != 0) {
         fclose(file);
         free(buffer);
         *actual_lines = 0;
         return;
     }
     
-    // Pula até a linha de início desejada
-    while (current_line < start_line && fgets(line, sizeof(line), file)) {
-        current_line++;
-    }
-    
     // Lê o pedaço com parsing otimizado
     while (count < num_lines && fgets(line, sizeof(line), file)) {
-        // Parsing rápido do CSV - encontra delimitadores manualmente
-        char* artist_start = line;  // Início do nome do artista
-        char* song_start = strchr(line, '|');  // Procura o primeiro separador
-        if (!song_start) continue;  // Pula se não encontrar o separador
-        *song_start++ = '\0';  // Termina a string do artista
-        
-        char* text_start = strchr(song_start, '|');  // Procura o segundo separador
-        if (!text_start) continue;  // Pula se não encontrar o separador
-        *text_start++ = '\0';  // Termina a string da música
-        
-        // Remove quebra de linha do texto
-        char* newline = strchr(text_start, '\n');
-        if (newline) *newline = '\0';
-        
-        // Copia para a estrutura com verificação de limites
-        int artist_len = strlen(artist_start);
-        int song_len = strlen(song_start);
-        int text_len = strlen(text_start);
-        
-        // Calcula o tamanho a copiar respeitando os limites máximos
-        int copy_artist_len = (artist_len < MAX_ARTIST_LENGTH - 1) ? artist_len : MAX_ARTIST_LENGTH - 1;
-        int copy_song_len = (song_len < MAX_SONG_LENGTH - 1) ? song_len : MAX_SONG_LENGTH - 1;
-        int copy_text_len = (text_len < MAX_TEXT_LENGTH - 1) ? text_len : MAX_TEXT_LENGTH - 1;
-        
-        // Copia os dados para a estrutura
-        strncpy(songs[count].artist, artist_start, copy_artist_len);
-        songs[count].artist[copy_artist_len] = '\0';
-        
-        strncpy(songs[count].song, song_start, copy_song_len);
-        songs[count].song[copy_song_len] = '\0';
-        
-        strncpy(songs[count].text, text_start, copy_text_len);
-        songs[count].text[copy_text_len] = '\0';
-        
-        count++;
+        if (parse_song_line(line, &songs[count])) count++;  // Pula linhas sem os separadores
     }
     
     fclose(file);
@@ -231,326 +706,746 @@ void read_file_chunk_optimized(const char* filename, int start_line, int num_lin
     *actual_lines = count;  // Retorna quantas linhas foram realmente lidas
 }
 
-void count_words_io_optimized(const char* filename, int total_songs, WordCount* word_counts, int* num_words, int world_rank, int world_size) {
-    // : Each process processes chunks of lines
-    WordCount* local_words = (WordCount*)malloc(MAX_WORDS * sizeof(WordCount));
-    int local_num_words = 0;
+// Lê linhas avulsas (em ordem crescente) com um único arquivo aberto: só há fseeko entre
+// linhas não consecutivas, e o buffer padrão evita recarregar 1MB a cada salto
+void read_file_lines_optimized(const char* filename, const LineIndex* index, int* lines, int num_lines, SongData* songs, int* actual_lines) {
+    *actual_lines = 0;
+    FILE* file = fopen(filename, "r");
+    if (!file) return;
     
-    int current_line = world_rank * LINES_PER_CHUNK; // Start with different chunks for each process
-    int processed_count = 0;
+    char line[MAX_LINE_LENGTH];
+    int count = 0;
+    int position = -1;  // Linha em que o arquivo está posicionado (-1 = desconhecida)
+    for (int i = 0; i < num_lines; i++) {
+        int target = lines[i];
+        if (target < 0 || target >= index->num_lines) continue;
+        if (target != position && fseeko(file, (off_t)index->offsets[target], SEEK_SET) != 0) continue;
+        if (!fgets(line, sizeof(line), file)) {
+            position = -1;
+            continue;
+        }
+        // Uma linha maior que o buffer deixa o arquivo no meio dela: o próximo acesso faz fseeko
+        position = strchr(line, '\n') ? target + 1 : -1;
+        if (parse_song_line(line, &songs[count])) {
+            lines[count++] = target;
+        }
+    }
     
-    printf(": Process %d will process %d lines at a time\n", world_rank, LINES_PER_CHUNK);
-    printf("Process %d starting with line %d\n", world_rank, current_line);
+    fclose(file);
+    *actual_lines = count;
+}
+
+// Abre o leitor de músicas: no modo mmap o CSV é mapeado uma única vez
+SongReader* open_song_reader(const char* filename, const LineIndex* index, int use_mmap) {
+    SongReader* reader = (SongReader*)malloc(sizeof(SongReader));
+    reader->filename = filename;
+    reader->index = index;
+    reader->mapped = NULL;
+    reader->store = NULL;
+    reader->songs = NULL;
+    reader->views = NULL;
+    reader->capacity = 0;
+    reader->owns_mapping = 1;
+    reader->first_line = 0;
     
-    //  loop: each process processes chunks, then gets the next available chunk
-    while (current_line < total_songs) {
-        int chunk_size = (current_line + LINES_PER_CHUNK > total_songs) ? (total_songs - current_line) : LINES_PER_CHUNK;
-        
-        SongData* songs = (SongData*)malloc(chunk_size * sizeof(SongData));
-        int actual_lines;
-        
-        read_file_chunk_optimized(filename, current_line, chunk_size, songs, &actual_lines);
-        
+    if (use_mmap) {
+        reader->mapped = mapped_csv_open(filename);
+        if (!reader->mapped) {
+            free(reader);
+            return NULL;
+        }
+    }
+    return reader;
+}
+
+// Abre o leitor sobre as linhas locais lidas com MPI-IO: as visões apontam para a faixa
+// em memória, como no modo mmap, e os índices de linha continuam globais
+SongReader* open_partition_reader(const char* filename, CsvPartition* partition) {
+    SongReader* reader = (SongReader*)malloc(sizeof(SongReader));
+    reader->filename = filename;
+    reader->index = &partition->index;
+    reader->mapped = &partition->csv;
+    reader->store = NULL;
+    reader->songs = NULL;
+    reader->views = NULL;
+    reader->capacity = 0;
+    reader->owns_mapping = 0;  // A faixa pertence ao CsvPartition
+    reader->first_line = partition->first_line;
+    return reader;
+}
+
+// Abre o leitor sobre o arquivo colunar: cada música é montada direto das colunas
+SongReader* open_store_reader(const char* filename, SongStore* store) {
+    SongReader* reader = (SongReader*)malloc(sizeof(SongReader));
+    reader->filename = filename;
+    reader->index = NULL;
+    reader->mapped = NULL;
+    reader->store = store;
+    reader->songs = NULL;
+    reader->views = NULL;
+    reader->capacity = 0;
+    reader->owns_mapping = 1;  // Fecha o arquivo colunar junto com o leitor
+    reader->first_line = 0;
+    return reader;
+}
+
+// Cria um segundo leitor sobre o mesmo arquivo (e o mesmo mapeamento), com buffers
+// próprios: um pedaço pode ser lido enquanto as visões do outro ainda estão em uso
+SongReader* clone_song_reader(const SongReader* reader) {
+    SongReader* clone = (SongReader*)malloc(sizeof(SongReader));
+    clone->filename = reader->filename;
+    clone->index = reader->index;
+    clone->mapped = reader->mapped;
+    clone->store = reader->store;
+    clone->songs = NULL;
+    clone->views = NULL;
+    clone->capacity = 0;
+    clone->owns_mapping = 0;
+    clone->first_line = reader->first_line;
+    return clone;
+}
+
+// Lê um pedaço do CSV e devolve visões para cada música
+const SongView* read_song_chunk(SongReader* reader, int start_line, int num_lines, int* actual_lines) {
+    // Aumenta os buffers apenas quando o pedaço pedido é maior que os anteriores
+    if (num_lines > reader->capacity) {
+        reader->views = (SongView*)realloc(reader->views, num_lines * sizeof(SongView));
+        if (!reader->mapped && !reader->store) {
+            reader->songs = (SongData*)realloc(reader->songs, num_lines * sizeof(SongData));
+        }
+        reader->capacity = num_lines;
+    }
+    
+    // Arquivo colunar: visões montadas pelos offsets das colunas, em O(1) por música
+    if (reader->store) {
+        *actual_lines = song_store_read_chunk(reader->store, start_line, num_lines, reader->views);
+        return reader->views;
+    }
+    
+    // Modo mmap: visões apontam direto para o arquivo, sem cópias nem limite de tamanho
+    if (reader->mapped) {
+        *actual_lines = mapped_csv_read_chunk(reader->mapped, reader->index, start_line - reader->first_line, num_lines, reader->views);
+        return reader->views;
+    }
+    
+    // Modo stdio: lê para o buffer de SongData e aponta as visões para ele
+    read_file_chunk_optimized(reader->filename, reader->index, start_line, num_lines, reader->songs, actual_lines);
+    for (int i = 0; i < *actual_lines; i++) {
+        reader->views[i].artist = reader->songs[i].artist;
+        reader->views[i].artist_len = strlen(reader->songs[i].artist);
+        reader->views[i].song = reader->songs[i].song;
+        reader->views[i].song_len = strlen(reader->songs[i].song);
+        reader->views[i].text = reader->songs[i].text;
+        reader->views[i].text_len = strlen(reader->songs[i].text);
+    }
+    return reader->views;
+}
+
+// Lê músicas avulsas (índices globais em ordem crescente) e devolve visões para cada uma;
+// 'lines' é compactado para os índices das músicas efetivamente lidas
+const SongView* read_song_lines(SongReader* reader, int* lines, int num_lines, int* actual_lines) {
+    if (num_lines > reader->capacity) {
+        reader->views = (SongView*)realloc(reader->views, num_lines * sizeof(SongView));
+        if (!reader->mapped && !reader->store) {
+            reader->songs = (SongData*)realloc(reader->songs, num_lines * sizeof(SongData));
+        }
+        reader->capacity = num_lines;
+    }
+    
+    // Arquivo colunar e mmap: cada música é montada direto da memória, sem custo de abertura
+    if (reader->store || reader->mapped) {
+        int count = 0;
+        for (int i = 0; i < num_lines; i++) {
+            int got = reader->store
+                ? song_store_read_chunk(reader->store, lines[i], 1, reader->views + count)
+                : mapped_csv_read_chunk(reader->mapped, reader->index, lines[i] - reader->first_line, 1, reader->views + count);
+            if (got == 1) lines[count++] = lines[i];
+        }
+        *actual_lines = count;
+        return reader->views;
+    }
+    
+    // Modo stdio: um único arquivo aberto para todas as linhas
+    read_file_lines_optimized(reader->filename, reader->index, lines, num_lines, reader->songs, actual_lines);
+    for (int i = 0; i < *actual_lines; i++) {
+        reader->views[i].artist = reader->songs[i].artist;
+        reader->views[i].artist_len = strlen(reader->songs[i].artist);
+        reader->views[i].song = reader->songs[i].song;
+        reader->views[i].song_len = strlen(reader->songs[i].song);
+        reader->views[i].text = reader->songs[i].text;
+        reader->views[i].text_len = strlen(reader->songs[i].text);
+    }
+    return reader->views;
+}
+
+// Libera o leitor de músicas e desfaz o mapeamento
+void close_song_reader(SongReader* reader) {
+    if (reader) {
+        if (reader->owns_mapping) {
+            mapped_csv_close(reader->mapped);
+            song_store_close(reader->store);
+        }
+        free(reader->songs);
+        free(reader->views);
+        free(reader);
+    }
+}
+
+// Passada sobre o CSV: cada processo lê seus pedaços e entrega cada música a todos os analisadores
+// Lê um pedaço registrando o tempo de I/O e os bytes, músicas e pedaços lidos
+const SongView* read_counted_chunk(SongReader* reader, int start_line, int num_lines, int* actual_lines) {
+    StatActivity previous = rank_stats_enter(STAT_IO);
+    const SongView* songs = read_song_chunk(reader, start_line, num_lines, actual_lines);
+    long long bytes = 0;
+    for (int i = 0; i < *actual_lines; i++) {
+        bytes += songs[i].artist_len + songs[i].song_len + songs[i].text_len + 3;  // + dois '|' e o '\n'
+    }
+    rank_stats_add(STAT_BYTES_READ, bytes);
+    rank_stats_add(STAT_RECORDS, *actual_lines);
+    rank_stats_add(STAT_CHUNKS, 1);
+    rank_stats_enter(previous);
+    return songs;
+}
+
+// Lê um pedaço e entrega cada música a todos os analisadores
+int analyze_chunk(SongReader* reader, const RunOptions* options, int start_line, int num_lines, Analyzer* analyzers, int num_analyzers, int world_rank) {
+    int actual_lines;
+    const SongView* songs = read_counted_chunk(reader, start_line, num_lines, &actual_lines);
+    
+    if (!options->quiet) {
         printf(": Process %d processing chunk starting at line %d (%d lines)\n", 
-               world_rank, current_line, actual_lines);
-        
-        // Process words in this chunk
-        for (int i = 0; i < actual_lines; i++) {
-            char* text = songs[i].text;
-            char* word_start = text;
-            
-            while (*word_start) {
-                // Skip non-alphabetic characters
-                while (*word_start && !isalpha(*word_start)) {
-                    word_start++;
-                }
-                
-                if (!*word_start) break;
-                
-                char* word_end = word_start;
-                while (*word_end && isalpha(*word_end)) {
-                    word_end++;
-                }
-                
-                if (word_end > word_start) {
-                    char word[MAX_WORD_LENGTH];
-                    int word_len = word_end - word_start;
-                    
-                    // Skip very short words
-                    if (word_len < 2 || word_len > 50) {
-                        word_start = word_end;
-                        continue;
-                    }
-                    
-                    // Convert to lowercase
-                    for (int j = 0; j < word_len && j < MAX_WORD_LENGTH - 1; j++) {
-                        char c = word_start[j];
-                        word[j] = (c >= 'A' && c <= 'Z') ? (c - 'A' + 'a') : c;
-                    }
-                    word[word_len] = '\0';
-                    
-                    // Search for existing word
-                    int found = 0;
-                    for (int k = 0; k < local_num_words; k++) {
-                        if (strcmp(local_words[k].word, word) == 0) {
-                            local_words[k].count++;
-                            found = 1;
-                            break;
-                        }
-                    }
-                    
-                    if (!found && local_num_words < MAX_WORDS - 1) {
-                        strcpy(local_words[local_num_words].word, word);
-                        local_words[local_num_words].count = 1;
-                        local_num_words++;
-                    }
-                }
-                
-                word_start = word_end;
-            }
+               world_rank, start_line, actual_lines);
+    }
+    
+    // Each song is parsed once and handed to every registered analyzer
+    StatActivity previous = rank_stats_enter(STAT_TOKENIZE);
+    for (int i = 0; i < actual_lines; i++) {
+        for (int a = 0; a < num_analyzers; a++) {
+            analyzers[a].process_song(analyzers[a].state, &songs[i], start_line + i);
         }
-        
+    }
+    rank_stats_enter(previous);
+    return actual_lines;
+}
+
+// Devolve o próximo pedaço deste processo (dinâmico ou em rodízio)
+int next_pass_chunk(ChunkCursor* cursor, int* start_line, int* num_lines) {
+    if (cursor->scheduler) {
+        StatActivity previous = rank_stats_enter(STAT_COMM);
+        int claimed = chunk_scheduler_next(cursor->scheduler, start_line, num_lines);
+        rank_stats_enter(previous);
+        if (!claimed) return 0;
+        *start_line += cursor->offset;
+        return 1;
+    }
+    if (cursor->next_line >= cursor->total) {
+        return 0;
+    }
+    *start_line = cursor->next_line;
+    *num_lines = (cursor->next_line + LINES_PER_CHUNK > cursor->total) ? (cursor->total - cursor->next_line) : LINES_PER_CHUNK;
+    cursor->next_line += cursor->stride;
+    return 1;
+}
+
+// Passada com threads: as threads analisam o pedaço atual enquanto a thread principal
+// reserva e lê o próximo no segundo leitor (double buffering). Só a thread principal chama MPI.
+void run_threaded_pass(SongReader* reader, const RunOptions* options, ChunkCursor* cursor, Analyzer* analyzers, int num_analyzers, int world_rank) {
+    int num_threads = options->threads;
+    WorkerPool* pool = worker_pool_create(num_threads, analyzers, num_analyzers);
+    SongReader* readers[2] = { reader, clone_song_reader(reader) };
+    int current = 0;
+    int processed_count = 0;
+    int chunks = 0;
+    
+    if (!options->quiet) {
+        printf(": Process %d will analyze chunks with %d threads\n", world_rank, num_threads);
+    }
+    
+    int start_line, num_lines, actual_lines = 0;
+    const SongView* songs = NULL;
+    int has_chunk = next_pass_chunk(cursor, &start_line, &num_lines);
+    if (has_chunk) {
+        songs = read_counted_chunk(readers[current], start_line, num_lines, &actual_lines);
+    }
+    
+    while (has_chunk) {
+        if (!options->quiet) {
+            printf(": Process %d processing chunk starting at line %d (%d lines)\n", world_rank, start_line, actual_lines);
+        }
+        worker_pool_submit(pool, songs, actual_lines, start_line);
         processed_count += actual_lines;
-        free(songs); // Free chunk immediately
+        chunks++;
+        
+        // Overlap: read the next chunk into the other buffer while the threads work on this one
+        int next_start, next_lines, next_actual = 0;
+        const SongView* next_songs = NULL;
+        has_chunk = next_pass_chunk(cursor, &next_start, &next_lines);
+        if (has_chunk) {
+            next_songs = read_counted_chunk(readers[1 - current], next_start, next_lines, &next_actual);
+        }
         
-        printf(": Process %d completed chunk. Total processed: %d songs, words: %d\n", 
-               world_rank, processed_count, local_num_words);
+        // Time spent waiting for the threads is analysis time not hidden behind the read
+        StatActivity previous = rank_stats_enter(STAT_TOKENIZE);
+        worker_pool_wait(pool);
+        rank_stats_enter(previous);
+        if (!options->quiet) {
+            printf(": Process %d completed chunk. Total processed: %d songs\n", world_rank, processed_count);
+        }
         
-        // Get next chunk: current_line += world_size * LINES_PER_CHUNK (round-robin distribution)
-        current_line += world_size * LINES_PER_CHUNK;
+        current = 1 - current;
+        songs = next_songs;
+        start_line = next_start;
+        actual_lines = next_actual;
+    }
+    
+    StatActivity previous = rank_stats_enter(STAT_MERGE);
+    worker_pool_free(pool);  // Soma os estados das threads nos analisadores principais
+    rank_stats_enter(previous);
+    close_song_reader(readers[1]);
+    if (!options->quiet) {
+        printf(": Process %d completed. Processed %d songs in %d chunks.\n", world_rank, processed_count, chunks);
+    }
+}
+
+void run_analysis_pass(SongReader* reader, const RunOptions* options, int total_songs, Analyzer* analyzers, int num_analyzers, int world_rank, int world_size) {
+    int processed_count = 0;
+    
+    ChunkCursor cursor;
+    cursor.scheduler = NULL;
+    cursor.next_line = options->start_song + world_rank * LINES_PER_CHUNK; // Start with different chunks for each process
+    cursor.offset = options->start_song;  // Incremental runs skip the songs already in the saved state
+    cursor.stride = world_size * LINES_PER_CHUNK;
+    cursor.total = total_songs;
+    if (options->mpiio) {
+        // Each rank walks the contiguous block of lines it read with MPI-IO
+        cursor.next_line = (reader->first_line > options->start_song) ? reader->first_line : options->start_song;
+        cursor.stride = LINES_PER_CHUNK;
+        cursor.total = reader->first_line + reader->index->num_lines;
+    } else if (options->dynamic) {
+        // Each rank claims its next chunk from a shared counter; chunk size follows its measured throughput
+        cursor.scheduler = chunk_scheduler_create(total_songs - options->start_song, LINES_PER_CHUNK, 0, MPI_COMM_WORLD);
     }
     
-    printf(": Process %d completed. Processed %d songs, found %d unique words.\n", 
-           world_rank, processed_count, local_num_words);
+    if (options->threads > 1) {
+        run_threaded_pass(reader, options, &cursor, analyzers, num_analyzers, world_rank);
+        chunk_scheduler_free(cursor.scheduler);
+        return;
+    }
     
-    // Gather results
-    if (world_rank == 0) {
-        // Copy local results
-        *num_words = local_num_words;
-        memcpy(word_counts, local_words, local_num_words * sizeof(WordCount));
-        
-        // Receive from other processes
-        for (int proc = 1; proc < world_size; proc++) {
-            int proc_num_words;
-            MPI_Recv(&proc_num_words, 1, MPI_INT, proc, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-            
-            WordCount* proc_words = (WordCount*)malloc(proc_num_words * sizeof(WordCount));
-            MPI_Recv(proc_words, proc_num_words * sizeof(WordCount), MPI_BYTE, proc, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-            
-            // Merge results
-            for (int i = 0; i < proc_num_words; i++) {
-                int found = 0;
-                for (int j = 0; j < *num_words; j++) {
-                    if (strcmp(word_counts[j].word, proc_words[i].word) == 0) {
-                        word_counts[j].count += proc_words[i].count;
-                        found = 1;
-                        break;
-                    }
-                }
-                if (!found && *num_words < MAX_WORDS - 1) {
-                    strcpy(word_counts[*num_words].word, proc_words[i].word);
-                    word_counts[*num_words].count = proc_words[i].count;
-                    (*num_words)++;
-                }
+    int start_line, num_lines;
+    if (cursor.scheduler) {
+        if (!options->quiet) {
+            printf(": Process %d will claim chunks dynamically (starting with %d lines)\n", world_rank, LINES_PER_CHUNK);
+        }
+        while (next_pass_chunk(&cursor, &start_line, &num_lines)) {
+            processed_count += analyze_chunk(reader, options, start_line, num_lines, analyzers, num_analyzers, world_rank);
+            if (!options->quiet) {
+                printf(": Process %d completed chunk. Total processed: %d songs\n", 
+                       world_rank, processed_count);
             }
-            
-            free(proc_words);
         }
         
-        // Sort by count
-        qsort(word_counts, *num_words, sizeof(WordCount), compare_word_counts);
+        if (!options->quiet) {
+            printf(": Process %d completed. Processed %d songs in %d chunks.\n", world_rank, processed_count, cursor.scheduler->chunks);
+        }
+        chunk_scheduler_free(cursor.scheduler);
+        return;
+    }
+    
+    if (!options->quiet) {
+        printf(": Process %d will process %d lines at a time\n", world_rank, LINES_PER_CHUNK);
+        printf("Process %d starting with line %d\n", world_rank, cursor.next_line);
+    }
+    
+    //  loop: each process processes chunks, then gets the next available chunk
+    // (round-robin: current_line += world_size * LINES_PER_CHUNK; MPI-IO: the next chunk of its own block)
+    while (next_pass_chunk(&cursor, &start_line, &num_lines)) {
+        processed_count += analyze_chunk(reader, options, start_line, num_lines, analyzers, num_analyzers, world_rank);
         
-        printf(": Word counting completed. Found %d unique words.\n", *num_words);
-        printf("Top 10 most frequent words:\n");
-        for (int i = 0; i < 10 && i < *num_words; i++) {
-            printf("  %d. %s: %d occurrences\n", i + 1, word_counts[i].word, word_counts[i].count);
+        if (!options->quiet) {
+            printf(": Process %d completed chunk. Total processed: %d songs\n", 
+                   world_rank, processed_count);
         }
-    } else {
-        // Send results to process 0
-        MPI_Send(&local_num_words, 1, MPI_INT, 0, 0, MPI_COMM_WORLD);
-        MPI_Send(local_words, local_num_words * sizeof(WordCount), MPI_BYTE, 0, 1, MPI_COMM_WORLD);
     }
     
-    free(local_words);
+    if (!options->quiet) {
+        printf(": Process %d completed. Processed %d songs.\n", world_rank, processed_count);
+    }
 }
 
-void count_artists_io_optimized(const char* filename, int total_songs, ArtistCount* artist_counts, int* num_artists, int world_rank, int world_size) {
-    // : Each process processes chunks of lines
-    ArtistCount* local_artists = (ArtistCount*)malloc(MAX_ARTISTS * sizeof(ArtistCount));
-    int local_num_artists = 0;
+void count_words_io_optimized(SongReader* reader, const RunOptions* options, int total_songs, IncrementalState* state, NgramCounter* ngram_counter, NgramCount** ngram_counts, long long* num_ngrams, WordCount** word_counts, int* num_words, SketchBounds* bounds, int world_rank, int world_size) {
+    WordCounter* counter = word_counter_create(options->reduce_mode == REDUCE_SKETCH);
+    Analyzer analyzers[2] = { word_counter_analyzer(counter) };
+    int num_analyzers = 1;
+    if (ngram_counter) analyzers[num_analyzers++] = ngram_counter_analyzer(ngram_counter);  // Mesma passada
     
-    int current_line = world_rank * LINES_PER_CHUNK; // Start with different chunks for each process
-    int processed_count = 0;
+    run_analysis_pass(reader, options, total_songs, analyzers, num_analyzers, world_rank, world_size);
+    if (!options->quiet) {
+        printf(": Process %d found %lld unique words.\n", world_rank, word_counter_keys(counter));
+    }
+    rank_stats_add(STAT_TOKENS, word_counter_tokens(counter));
+    rank_stats_add(STAT_WORD_KEYS, word_counter_keys(counter));
     
-    printf(": Process %d will process %d lines at a time\n", world_rank, LINES_PER_CHUNK);
-    printf("Process %d starting with line %d\n", world_rank, current_line);
+    rank_stats_enter(STAT_MERGE);
+    if (state && world_rank == 0) incremental_state_restore(state->words, state->words_size, counter->table);
+    rank_stats_enter(STAT_COMM);
+    word_counter_reduce(counter, options->reduce_mode, word_counts, num_words, bounds, world_rank);
+    rank_stats_enter(STAT_OTHER);
+    if (state && world_rank == 0) incremental_state_capture(&state->words, &state->words_size, counter->table);
+    word_counter_free(counter);
     
-    //  loop: each process processes chunks, then gets the next available chunk
-    while (current_line < total_songs) {
-        int chunk_size = (current_line + LINES_PER_CHUNK > total_songs) ? (total_songs - current_line) : LINES_PER_CHUNK;
+    if (ngram_counter) {
+        rank_stats_enter(STAT_COMM);
+        ngram_counter_reduce(ngram_counter, ngram_counts, num_ngrams, world_rank, world_size);
+        rank_stats_enter(STAT_OTHER);
+    }
+}
+
+void count_artists_io_optimized(SongReader* reader, const RunOptions* options, int total_songs, IncrementalState* state, ArtistCount** artist_counts, int* num_artists, SketchBounds* bounds, int world_rank, int world_size) {
+    ArtistCounter* counter = artist_counter_create(options->reduce_mode == REDUCE_SKETCH);
+    Analyzer analyzer = artist_counter_analyzer(counter);
+    
+    run_analysis_pass(reader, options, total_songs, &analyzer, 1, world_rank, world_size);
+    if (!options->quiet) {
+        printf(": Process %d found %lld unique artists.\n", world_rank, artist_counter_keys(counter));
+    }
+    rank_stats_add(STAT_ARTIST_KEYS, artist_counter_keys(counter));
+    
+    rank_stats_enter(STAT_MERGE);
+    if (state && world_rank == 0) incremental_state_restore(state->artists, state->artists_size, counter->table);
+    rank_stats_enter(STAT_COMM);
+    artist_counter_reduce(counter, options->reduce_mode, artist_counts, num_artists, bounds, world_rank);
+    rank_stats_enter(STAT_OTHER);
+    if (state && world_rank == 0) incremental_state_capture(&state->artists, &state->artists_size, counter->table);
+    artist_counter_free(counter);
+}
+
+LlmSelector* select_llm_songs(SongReader* reader, const RunOptions* options, int total_songs, int world_rank) {
+    LlmSelector* selector = llm_selector_create(MAX_LLM_SONGS);
+    
+    // Only process 0 reads the songs for LLM classification; with MPI-IO each process
+    // selects the first songs that fall inside its own block
+    int first_song = 0, end_song = 0;
+    if (options->mpiio) {
+        first_song = reader->first_line;
+        end_song = reader->first_line + reader->index->num_lines;
+    } else if (world_rank == 0) {
+        end_song = total_songs;
+    }
+    if (end_song > MAX_LLM_SONGS) end_song = MAX_LLM_SONGS;
+    if (first_song < options->start_song) first_song = options->start_song;  // Já classificadas no estado salvo
+    
+    if (end_song > first_song) {
+        Analyzer analyzer = llm_selector_analyzer(selector);
         
-        SongData* songs = (SongData*)malloc(chunk_size * sizeof(SongData));
         int actual_lines;
-        
-        read_file_chunk_optimized(filename, current_line, chunk_size, songs, &actual_lines);
-        
-        printf(": Process %d processing chunk starting at line %d (%d lines)\n", 
-               world_rank, current_line, actual_lines);
-        
-        // Process artists in this chunk
+        StatActivity previous = rank_stats_enter(STAT_IO);
+        const SongView* songs = read_song_chunk(reader, first_song, end_song - first_song, &actual_lines);
+        rank_stats_enter(STAT_TOKENIZE);
         for (int i = 0; i < actual_lines; i++) {
-            char* artist = songs[i].artist;
-            
-            // Search for existing artist
-            int found = 0;
-            for (int k = 0; k < local_num_artists; k++) {
-                if (strcmp(local_artists[k].artist, artist) == 0) {
-                    local_artists[k].song_count++;
-                    found = 1;
-                    break;
-                }
-            }
-            
-            if (!found && local_num_artists < MAX_ARTISTS - 1) {
-                strcpy(local_artists[local_num_artists].artist, artist);
-                local_artists[local_num_artists].song_count = 1;
-                local_num_artists++;
-            }
+            analyzer.process_song(analyzer.state, &songs[i], first_song + i);
         }
-        
-        processed_count += actual_lines;
-        free(songs); // Free chunk immediately
-        
-        printf(": Process %d completed chunk. Total processed: %d songs, artists: %d\n", 
-               world_rank, processed_count, local_num_artists);
-        
-        // Get next chunk: current_line += world_size * LINES_PER_CHUNK (round-robin distribution)
-        current_line += world_size * LINES_PER_CHUNK;
+        rank_stats_enter(previous);
+    }
+    return selector;
+}
+
+void classify_sentiments_io_optimized(SongReader* reader, const RunOptions* options, int total_songs, int* sentiment_counts, int world_rank, int world_size) {
+    if (options->sample_max) {
+        classify_sampled_sentiments(reader, options, total_songs, sentiment_counts, world_rank, world_size);
+        return;
+    }
+    LlmSelector* selector = select_llm_songs(reader, options, total_songs, world_rank);
+    classify_selected_sentiments(selector, options, sentiment_counts, world_rank, world_size);
+    llm_selector_free(selector);
+}
+
+void classify_selected_sentiments(LlmSelector* selector, const RunOptions* options, int* sentiment_counts, int world_rank, int world_size) {
+    if (world_rank == 0) {
+        printf(": Classifying sentiments using Ollama...\n");
+        printf("Processing only %d songs for LLM analysis (to save time and memory)\n", MAX_LLM_SONGS);
     }
     
-    printf(": Process %d completed. Processed %d songs, found %d unique artists.\n", 
-           world_rank, processed_count, local_num_artists);
+    // Every rank classifies its share of the selected songs (song i goes to rank i % size)
+    rank_stats_enter(STAT_COMM);
+    llm_selector_distribute(selector, world_rank, world_size);
+    rank_stats_enter(STAT_LLM);
+    rank_stats_add(STAT_LLM_SONGS, selector->count);
     
-    // Gather results
-    if (world_rank == 0) {
-        // Copy local results
-        *num_artists = local_num_artists;
-        memcpy(artist_counts, local_artists, local_num_artists * sizeof(ArtistCount));
-        
-        // Receive from other processes
-        for (int proc = 1; proc < world_size; proc++) {
-            int proc_num_artists;
-            MPI_Recv(&proc_num_artists, 1, MPI_INT, proc, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-            
-            ArtistCount* proc_artists = (ArtistCount*)malloc(proc_num_artists * sizeof(ArtistCount));
-            MPI_Recv(proc_artists, proc_num_artists * sizeof(ArtistCount), MPI_BYTE, proc, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-            
-            // Merge results
-            for (int i = 0; i < proc_num_artists; i++) {
-                int found = 0;
-                for (int j = 0; j < *num_artists; j++) {
-                    if (strcmp(artist_counts[j].artist, proc_artists[i].artist) == 0) {
-                        artist_counts[j].song_count += proc_artists[i].song_count;
-                        found = 1;
-                        break;
-                    }
-                }
-                if (!found && *num_artists < MAX_ARTISTS - 1) {
-                    strcpy(artist_counts[*num_artists].artist, proc_artists[i].artist);
-                    artist_counts[*num_artists].song_count = proc_artists[i].song_count;
-                    (*num_artists)++;
-                }
-            }
-            
-            free(proc_artists);
+    SentimentJob job;
+    job.selector = selector;
+    job.options = options;
+    run_sentiment_job(&job);
+    finish_sentiment_job(&job, sentiment_counts, world_rank);
+}
+
+// Relógio monotônico em segundos (MPI_Wtime só pode ser chamado pela thread principal)
+static double monotonic_seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+void run_sentiment_job(SentimentJob* job) {
+    LlmSelector* selector = job->selector;
+    const RunOptions* options = job->options;
+    job->started = monotonic_seconds();
+    job->counts[0] = job->counts[1] = job->counts[2] = 0;
+    
+    // Songs already classified with the same model and prompt come from the cache. In batch
+    // mode a song may also be answered with the single-song prompt, so both keys are accepted
+    int capacity = selector->count > 0 ? selector->count : 1;
+    int* labels = (int*)malloc(capacity * sizeof(int));
+    char** missing_lyrics = (char**)malloc(capacity * sizeof(char*));
+    int* missing_songs = (int*)malloc(capacity * sizeof(int));
+    int num_missing = 0;
+    SentimentCache* cache = options->llm_cache_path ? sentiment_cache_open(options->llm_cache_path) : NULL;
+    for (int i = 0; i < selector->count; i++) {
+        labels[i] = -1;
+        if (cache && options->llm_batch > 1) {
+            labels[i] = sentiment_cache_lookup(cache, sentiment_cache_key(OLLAMA_MODEL_NAME, OLLAMA_BATCH_PRE_PROMPT, selector->lyrics[i]));
         }
+        if (cache && labels[i] < 0) {
+            labels[i] = sentiment_cache_lookup(cache, sentiment_cache_key(OLLAMA_MODEL_NAME, OLLAMA_PRE_PROMPT, selector->lyrics[i]));
+        }
+        if (labels[i] < 0) {
+            missing_lyrics[num_missing] = selector->lyrics[i];
+            missing_songs[num_missing++] = i;
+        }
+    }
+    
+    // Keep several requests in flight per rank through the libcurl multi interface
+    int classified = 0;
+    if (num_missing > 0) {
+        int* missing_labels = (int*)malloc(num_missing * sizeof(int));
+        int* missing_batched = (int*)malloc(num_missing * sizeof(int));
+        SentimentKey* missing_keys = (SentimentKey*)malloc(num_missing * sizeof(SentimentKey));
+        classified = classify_lyrics_concurrent(missing_lyrics, num_missing, options->llm_urls, options->num_llm_urls,
+                                                options->llm_concurrency, options->llm_batch, missing_labels, missing_batched);
         
-        // Sort by song count
-        qsort(artist_counts, *num_artists, sizeof(ArtistCount), compare_artist_counts);
-        
-        printf(": Artist counting completed. Found %d unique artists.\n", *num_artists);
-        printf("Top 10 artists with most songs:\n");
-        for (int i = 0; i < 10 && i < *num_artists; i++) {
-            printf("  %d. %s: %d songs\n", i + 1, artist_counts[i].artist, artist_counts[i].song_count);
+        // Each label is stored under the prompt that actually produced it
+        for (int i = 0; i < num_missing; i++) {
+            labels[missing_songs[i]] = missing_labels[i];
+            missing_keys[i] = sentiment_cache_key(OLLAMA_MODEL_NAME, missing_batched[i] ? OLLAMA_BATCH_PRE_PROMPT : OLLAMA_PRE_PROMPT,
+                                                  missing_lyrics[i]);
         }
-    } else {
-        // Send results to process 0
-        MPI_Send(&local_num_artists, 1, MPI_INT, 0, 0, MPI_COMM_WORLD);
-        MPI_Send(local_artists, local_num_artists * sizeof(ArtistCount), MPI_BYTE, 0, 1, MPI_COMM_WORLD);
+        if (cache) {
+            sentiment_cache_append(cache, missing_keys, missing_labels, num_missing);
+        }
+        free(missing_labels);
+        free(missing_batched);
+        free(missing_keys);
     }
     
-    free(local_artists);
+    for (int i = 0; i < selector->count; i++) {
+        if (labels[i] >= 0) {
+            job->counts[labels[i]]++;
+        }
+    }
+    job->from_cache = selector->count - num_missing;
+    job->missing = num_missing;
+    job->classified = classified;
+    sentiment_cache_close(cache);
+    free(labels);
+    free(missing_lyrics);
+    free(missing_songs);
+    job->finished = monotonic_seconds();
 }
 
-void classify_sentiments_io_optimized(const char* filename, int total_songs, int* sentiment_counts, int world_rank, int world_size) {
-    (void)world_size; // Suppress unused parameter warning
-    int local_sentiment_counts[3] = {0, 0, 0};
+void finish_sentiment_job(SentimentJob* job, int* sentiment_counts, int world_rank) {
+    if (!job->options->quiet) {
+        printf(": Process %d: %d/%d songs from cache, %d/%d classified by the LLM.\n", world_rank,
+               job->from_cache, job->selector->count, job->classified, job->missing);
+    }
+    
+    // Sum the per-rank counts on process 0
+    rank_stats_enter(STAT_COMM);
+    MPI_Reduce(job->counts, sentiment_counts, 3, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+    rank_stats_enter(STAT_OTHER);
     
     if (world_rank == 0) {
-        printf(": Classifying sentiments using Ollama...\n");
-        printf("Processing only %d songs for LLM analysis (to save time and memory)\n", MAX_LLM_SONGS);
+        printf(": Sentiment classification results:\n");
+        printf("Positive: %d songs\n", sentiment_counts[0]);
+        printf("Neutral: %d songs\n", sentiment_counts[1]);
+        printf("Negative: %d songs\n", sentiment_counts[2]);
     }
+}
+
+// Comparação de inteiros em ordem crescente (qsort)
+static int compare_ints(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+void classify_sampled_sentiments(SongReader* reader, const RunOptions* options, int total_songs, int* sentiment_counts, int world_rank, int world_size) {
+    // One song per stratum of the file, visited in bit-reversed order: every prefix is spread evenly
+    SamplePlan* plan = sample_plan_create(options->start_song, total_songs, options->sample_max);
+    int block_first = options->mpiio ? reader->first_line : 0;
+    int block_end = options->mpiio ? reader->first_line + reader->index->num_lines : total_songs;
     
-    // Only process 0 does LLM classification to avoid conflicts
+    // Each round keeps every rank's LLM requests in flight; the stop test runs between rounds
+    int round_size = world_size * options->llm_concurrency * options->llm_batch * 2;
     if (world_rank == 0) {
-        int songs_to_process = (total_songs < MAX_LLM_SONGS) ? total_songs : MAX_LLM_SONGS;
+        printf(": Classifying a stratified sample of up to %d of %d songs using Ollama (target 95%% CI width %.3f)...\n",
+               plan->count, plan->population, options->sample_ci);
+    }
+    
+    int* lines = (int*)malloc((round_size > 0 ? round_size : 1) * sizeof(int));
+    int totals[3] = {0, 0, 0};
+    int next = 0;
+    int rounds = 0;
+    double width = 1.0;
+    while (next < plan->count) {
+        int end = next + round_size < plan->count ? next + round_size : plan->count;
         
-        SongData* songs = (SongData*)malloc(songs_to_process * sizeof(SongData));
+        // Each rank reads its share of the round directly (with MPI-IO, the songs inside its block),
+        // sorted by line so the whole share is read with one pass over the file
+        int share = 0;
+        for (int j = next; j < end; j++) {
+            int song = plan->songs[j];
+            int mine = options->mpiio ? (song >= block_first && song < block_end) : (j % world_size == world_rank);
+            if (mine) lines[share++] = song;
+        }
+        qsort(lines, share, sizeof(int), compare_ints);
+        LlmSelector* selector = llm_selector_create(total_songs);
+        Analyzer analyzer = llm_selector_analyzer(selector);
+        rank_stats_enter(STAT_IO);
         int actual_lines;
-        
-        read_file_chunk_optimized(filename, 0, songs_to_process, songs, &actual_lines);
-        
+        const SongView* views = read_song_lines(reader, lines, share, &actual_lines);
         for (int i = 0; i < actual_lines; i++) {
-            char* result = classify_lyrics(songs[i].text);
-            if (result) {
-                int classification = atoi(result);
-                if (classification >= 0 && classification <= 2) {
-                    local_sentiment_counts[classification]++;
-                }
-                free(result);
-            }
-            
-            if ((i + 1) % 5 == 0) {
-                printf(": LLM processed %d/%d songs...\n", i + 1, actual_lines);
-            }
+            analyzer.process_song(analyzer.state, &views[i], lines[i]);
         }
+        rank_stats_enter(STAT_LLM);
+        rank_stats_add(STAT_LLM_SONGS, selector->count);
+        SentimentJob job;
+        job.selector = selector;
+        job.options = options;
+        run_sentiment_job(&job);
+        llm_selector_free(selector);
         
-        free(songs);
+        // All ranks see the same totals and take the same stop decision
+        int round_counts[3];
+        rank_stats_enter(STAT_COMM);
+        MPI_Allreduce(job.counts, round_counts, 3, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+        rank_stats_enter(STAT_OTHER);
+        for (int i = 0; i < 3; i++) {
+            totals[i] += round_counts[i];
+        }
+        next = end;
+        rounds++;
+        width = sample_ci_width(totals, plan->population);
+        int classified = totals[0] + totals[1] + totals[2];
+        if (world_rank == 0 && !options->quiet) {
+            printf(": Round %d: %d songs classified, worst 95%% CI width %.3f\n", rounds, classified, width);
+        }
+        if (classified >= SAMPLE_MIN_SONGS && width <= options->sample_ci) break;
     }
     
-    // Broadcast results to all processes
-    MPI_Bcast(local_sentiment_counts, 3, MPI_INT, 0, MPI_COMM_WORLD);
-    
-    // Copy to output
-    memcpy(sentiment_counts, local_sentiment_counts, 3 * sizeof(int));
-    
     if (world_rank == 0) {
+        for (int i = 0; i < 3; i++) {
+            sentiment_counts[i] = totals[i];
+        }
+        int classified = totals[0] + totals[1] + totals[2];
+        printf(": Stratified sample: %d of %d planned songs after %d round(s), worst 95%% CI width %.3f (target %.3f)%s\n",
+               next, plan->count, rounds, width, options->sample_ci,
+               width <= options->sample_ci ? "" : " - sample exhausted before reaching the target");
         printf(": Sentiment classification results:\n");
-        printf("Positive: %d songs\n", sentiment_counts[0]);
-        printf("Neutral: %d songs\n", sentiment_counts[1]);
-        printf("Negative: %d songs\n", sentiment_counts[2]);
+        const char* names[3] = {"Positive", "Neutral", "Negative"};
+        for (int i = 0; i < 3; i++) {
+            double p = classified > 0 ? (double)totals[i] / classified : 0.0;
+            printf("%s: %d songs (estimated %.1f%% of the file)\n", names[i], totals[i], p * 100);
+        }
+    }
+    free(lines);
+    sample_plan_free(plan);
+}
+
+// Corpo da thread de fundo: só cache e HTTP, nenhuma chamada MPI (MPI_THREAD_FUNNELED)
+static void* sentiment_job_thread(void* arg) {
+    run_sentiment_job((SentimentJob*)arg);
+    return NULL;
+}
+
+SentimentJob* start_async_sentiments(SongReader* reader, const RunOptions* options, int total_songs, int world_rank, int world_size) {
+    // Selection and redistribution use MPI, so they stay on the main thread
+    LlmSelector* selector = select_llm_songs(reader, options, total_songs, world_rank);
+    StatActivity previous = rank_stats_enter(STAT_COMM);
+    llm_selector_distribute(selector, world_rank, world_size);
+    rank_stats_enter(previous);
+    rank_stats_add(STAT_LLM_SONGS, selector->count);
+    
+    SentimentJob* job = (SentimentJob*)malloc(sizeof(SentimentJob));
+    job->selector = selector;
+    job->options = options;
+    job->running = pthread_create(&job->thread, NULL, sentiment_job_thread, job) == 0;
+    if (!job->running) {
+        run_sentiment_job(job);  // Sem thread: classifica agora, antes das contagens
+    }
+    if (world_rank == 0) {
+        printf(": Sentiment classification of up to %d songs started in the background\n", MAX_LLM_SONGS);
+    }
+    return job;
+}
+
+void join_async_sentiments(SentimentJob* job, int* sentiment_counts, int world_rank) {
+    // Only the part of the LLM phase that did not overlap the counting is charged here
+    StatActivity previous = rank_stats_enter(STAT_LLM);
+    double waited = monotonic_seconds();
+    if (job->running) {
+        pthread_join(job->thread, NULL);
+    }
+    waited = monotonic_seconds() - waited;
+    rank_stats_enter(previous);
+    if (!job->options->quiet) {
+        printf(": Process %d: LLM phase took %.2f s in the background, %.2f s of it after the counting.\n",
+               world_rank, job->finished - job->started, waited);
     }
+    finish_sentiment_job(job, sentiment_counts, world_rank);
+    llm_selector_free(job->selector);
+    free(job);
 }
 
-void print_results(WordCount* word_counts, int num_words, ArtistCount* artist_counts, int num_artists, int* sentiment_counts) {
+void print_results(WordCount* word_counts, int num_words, const SketchBounds* word_bounds, ArtistCount* artist_counts, int num_artists, const SketchBounds* artist_bounds, int* sentiment_counts, NgramCount* ngram_counts, long long num_ngrams, int ngram_n) {
     printf("\n");
     printf("========================================\n");
     printf("FINAL RESULTS SUMMARY - \n");
     printf("========================================\n");
     
     printf("\n1. WORD COUNTING:\n");
-    printf("Total unique words found: %d\n", num_words);
+    if (word_bounds) {
+        printf("Total unique words found: ~%d (HyperLogLog, standard error ±%.1f%%)\n", num_words, word_bounds->distinct_error * 100);
+    } else if (num_words >= 0) {
+        printf("Total unique words found: %d\n", num_words);
+    } else {
+        printf("Total unique words found: not computed (--topk-tput)\n");
+    }
     printf("Top 10 most frequent words:\n");
-    for (int i = 0; i < 10 && i < num_words; i++) {
+    for (int i = 0; i < 10 && word_counts[i].count > 0; i++) {
         printf("  %d. %s: %d occurrences\n", i + 1, word_counts[i].word, word_counts[i].count);
     }
+    if (word_bounds) {
+        // Count-Min never underestimates: true count is in [estimate - eps*N, estimate]
+        printf("  (Count-Min estimates: each may exceed the true count by at most %llu of %llu words, with %.1f%% confidence)\n",
+               (unsigned long long)word_bounds->count_error, (unsigned long long)word_bounds->total, word_bounds->confidence * 100);
+    }
     
     printf("\n2. ARTIST ANALYSIS:\n");
-    printf("Total unique artists found: %d\n", num_artists);
+    if (artist_bounds) {
+        printf("Total unique artists found: ~%d (HyperLogLog, standard error ±%.1f%%)\n", num_artists, artist_bounds->distinct_error * 100);
+    } else if (num_artists >= 0) {
+        printf("Total unique artists found: %d\n", num_artists);
+    } else {
+        printf("Total unique artists found: not computed (--topk-tput)\n");
+    }
     printf("Top 10 artists with most songs:\n");
-    for (int i = 0; i < 10 && i < num_artists; i++) {
+    for (int i = 0; i < 10 && artist_counts[i].song_count > 0; i++) {
         printf("  %d. %s: %d songs\n", i + 1, artist_counts[i].artist, artist_counts[i].song_count);
     }
+    if (artist_bounds) {
+        printf("  (Count-Min estimates: each may exceed the true count by at most %llu of %llu songs, with %.1f%% confidence)\n",
+               (unsigned long long)artist_bounds->count_error, (unsigned long long)artist_bounds->total, artist_bounds->confidence * 100);
+    }
     
     printf("\n3. SENTIMENT CLASSIFICATION:\n");
     printf("Positive: %d songs\n", sentiment_counts[0]);
@@ -565,17 +1460,14 @@ void print_results(WordCount* word_counts, int num_words, ArtistCount* artist_co
         printf("  Negative: %.1f%%\n", (float)sentiment_counts[2] / total_classified * 100);
     }
     
+    if (ngram_counts) {
+        printf("\n4. %d-GRAM COUNTING:\n", ngram_n);
+        printf("Total unique %d-grams found: %lld\n", ngram_n, num_ngrams);
+        printf("Top 10 most frequent %d-grams:\n", ngram_n);
+        for (int i = 0; i < 10 && ngram_counts[i].count > 0; i++) {
+            printf("  %d. %s: %d occurrences\n", i + 1, ngram_counts[i].text, ngram_counts[i].count);
+        }
+    }
+    
     printf("\n Analysis completed successfully!\n");
 }
-
-int compare_word_counts(const void* a, const void* b) {
-    WordCount* word_a = (WordCount*)a;
-    WordCount* word_b = (WordCount*)b;
-    return word_b->count - word_a->count; // Descending order
-}
-
-int compare_artist_counts(const void* a, const void* b) {
-    ArtistCount* artist_a = (ArtistCount*)a;
-    ArtistCount* artist_b = (ArtistCount*)b;
-    return artist_b->song_count - artist_a->song_count; // Descending order
-}
\ No newline at end of file
@@ -0,0 +1,390 @@
+#include "ngram_counter.h"
+#include <stdio.h>           // Para printf e snprintf
+#include <stdlib.h>          // Para funções de alocação de memória
+#include <string.h>          // Para memcpy
+#include <mpi.h>             // Para juntar os resultados entre processos
+#include "count_codec.h"     // Para os varints da troca e os textos dos sobreviventes
+#include "count_exchange.h"  // Para o dono de cada chave e a junção de bytes no root
+#include "rank_stats.h"      // Para separar o tempo de soma do tempo de comunicação
+
+#define NGRAM_TEXTS_INITIAL 4096  // Tamanho inicial da tabela lateral de textos
+
+// Entrada a enviar na troca: hash, contagem e processo dono
+typedef struct {
+    uint64_t hash;
+    uint32_t count;
+    int owner;
+} NgramEntry;
+
+// Cria o vetor de entradas com capacidade para 'expected_keys' abaixo de 75% de ocupação
+static void init_table(NgramCounter *counter, size_t expected_keys) {
+    size_t capacity = 16;
+    while (capacity * 3 < expected_keys * 4) capacity *= 2;
+    counter->slots = calloc(capacity, sizeof(NgramSlot));
+    counter->capacity = capacity;
+    counter->size = 0;
+}
+
+// Cria um contador de n-gramas vazio
+NgramCounter* ngram_counter_create(int n) {
+    NgramCounter *counter = malloc(sizeof(NgramCounter));
+    counter->n = n;
+    init_table(counter, NGRAM_TABLE_INITIAL_KEYS);
+    counter->texts = malloc(NGRAM_TEXTS_INITIAL);
+    counter->texts_used = 0;
+    counter->texts_capacity = NGRAM_TEXTS_INITIAL;
+    counter->total = 0;
+    counter->window_fill = 0;
+    counter->window_next = 0;
+    return counter;
+}
+
+// Libera a memória do contador de n-gramas
+void ngram_counter_free(NgramCounter *counter) {
+    if (counter) {
+        free(counter->slots);
+        free(counter->texts);
+        free(counter);
+    }
+}
+
+// Dobra a capacidade e reposiciona as entradas pelo hash guardado
+static void grow_table(NgramCounter *counter) {
+    size_t new_capacity = counter->capacity * 2;
+    size_t mask = new_capacity - 1;
+    NgramSlot *new_slots = calloc(new_capacity, sizeof(NgramSlot));
+
+    for (size_t i = 0; i < counter->capacity; i++) {
+        if (counter->slots[i].hash == 0) continue;
+        size_t pos = (size_t)counter->slots[i].hash & mask;
+        while (new_slots[pos].hash != 0) pos = (pos + 1) & mask;
+        new_slots[pos] = counter->slots[i];
+    }
+
+    free(counter->slots);
+    counter->slots = new_slots;
+    counter->capacity = new_capacity;
+}
+
+// Soma um valor à contagem do hash, inserindo-o se ainda não existir
+static NgramSlot* add_hash(NgramCounter *counter, uint64_t hash, uint32_t amount) {
+    size_t mask = counter->capacity - 1;
+    size_t pos = (size_t)hash & mask;
+
+    // Chaves de largura fixa: basta comparar o hash, sem bytes de texto
+    while (counter->slots[pos].hash != 0) {
+        if (counter->slots[pos].hash == hash) {
+            counter->slots[pos].count += amount;
+            return &counter->slots[pos];
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    if ((counter->size + 1) * 4 > counter->capacity * 3) {
+        grow_table(counter);
+        mask = counter->capacity - 1;
+        pos = (size_t)hash & mask;
+        while (counter->slots[pos].hash != 0) pos = (pos + 1) & mask;
+    }
+
+    NgramSlot *slot = &counter->slots[pos];
+    slot->hash = hash;
+    slot->count = amount;
+    slot->text = 0;
+    counter->size++;
+    return slot;
+}
+
+// Procura a entrada de um hash sem inseri-lo
+static const NgramSlot* find_hash(const NgramCounter *counter, uint64_t hash) {
+    size_t mask = counter->capacity - 1;
+    size_t pos = (size_t)hash & mask;
+    while (counter->slots[pos].hash != 0) {
+        if (counter->slots[pos].hash == hash) return &counter->slots[pos];
+        pos = (pos + 1) & mask;
+    }
+    return NULL;
+}
+
+// Copia um texto para a tabela lateral e devolve sua posição + 1
+static uint32_t store_text(NgramCounter *counter, const char *text, size_t len) {
+    if (counter->texts_used + len + 1 > counter->texts_capacity) {
+        while (counter->texts_used + len + 1 > counter->texts_capacity) {
+            counter->texts_capacity *= 2;
+        }
+        counter->texts = realloc(counter->texts, counter->texts_capacity);
+    }
+    size_t offset = counter->texts_used;
+    memcpy(counter->texts + offset, text, len);
+    counter->texts[offset + len] = '\0';
+    counter->texts_used += len + 1;
+    return (uint32_t)(offset + 1);
+}
+
+// Hash da sequência da janela, da palavra mais antiga para a mais nova
+// (combina os hashes das palavras; a ordem muda o resultado)
+static uint64_t window_hash(const NgramCounter *counter) {
+    uint64_t h = 0x9e3779b97f4a7c15ULL * (uint64_t)counter->n;
+    for (int i = 0; i < counter->n; i++) {
+        int pos = (counter->window_next + i) % counter->n;
+        h = (h ^ counter->window_hashes[pos]) * 0xff51afd7ed558ccdULL;
+        h ^= h >> 32;
+    }
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h ? h : 1;  // 0 é reservado para entradas vazias
+}
+
+// Monta o texto da janela (palavras separadas por espaço)
+static size_t window_text(const NgramCounter *counter, char *out) {
+    size_t len = 0;
+    for (int i = 0; i < counter->n; i++) {
+        int pos = (counter->window_next + i) % counter->n;
+        if (i > 0) out[len++] = ' ';
+        memcpy(out + len, counter->window_words[pos], counter->window_lens[pos]);
+        len += counter->window_lens[pos];
+    }
+    out[len] = '\0';
+    return len;
+}
+
+// Recebe uma palavra do tokenizador e conta o n-grama que termina nela
+static void ngram_counter_add_word(void *context, const char *word, int len) {
+    NgramCounter *counter = (NgramCounter*)context;
+    int pos = counter->window_next;
+    counter->window_hashes[pos] = count_table_hash(word, len);
+    memcpy(counter->window_words[pos], word, len);
+    counter->window_lens[pos] = len;
+    counter->window_next = (pos + 1) % counter->n;
+    if (counter->window_fill < counter->n) counter->window_fill++;
+    if (counter->window_fill < counter->n) return;
+
+    NgramSlot *slot = add_hash(counter, window_hash(counter), 1);
+    counter->total++;
+
+    // O texto só é guardado quando a chave se repete no processo: a maioria dos n-gramas aparece uma vez só
+    if (slot->text == 0 && slot->count >= NGRAM_TEXT_MIN_COUNT) {
+        char text[NGRAM_MAX_TEXT];
+        size_t text_len = window_text(counter, text);
+        slot->text = store_text(counter, text, text_len);
+    }
+}
+
+// Processa as palavras da letra de uma música (n-gramas não cruzam músicas)
+static void ngram_counter_process_song(void *state, const SongView *song, int song_index) {
+    (void)song_index;  // A posição da música não importa para a contagem
+    NgramCounter *counter = (NgramCounter*)state;
+    counter->window_fill = 0;
+    counter->window_next = 0;
+    tokenize_words(song->text, song->text_len, ngram_counter_add_word, counter);
+}
+
+// Cria um contador vazio, com o mesmo n, para uma thread
+static void* ngram_counter_clone(void *state) {
+    return ngram_counter_create(((NgramCounter*)state)->n);
+}
+
+// Soma o contador de uma thread no principal, levando os textos que faltam
+static void ngram_counter_merge(void *state, void *local) {
+    NgramCounter *counter = (NgramCounter*)state;
+    NgramCounter *other = (NgramCounter*)local;
+    for (size_t i = 0; i < other->capacity; i++) {
+        const NgramSlot *src = &other->slots[i];
+        if (src->hash == 0) continue;
+        NgramSlot *dst = add_hash(counter, src->hash, src->count);
+        if (dst->text == 0 && src->text != 0) {
+            const char *text = other->texts + src->text - 1;
+            dst->text = store_text(counter, text, strlen(text));
+        }
+    }
+    counter->total += other->total;
+    ngram_counter_free(other);
+}
+
+// Monta o analisador que alimenta o contador de n-gramas
+Analyzer ngram_counter_analyzer(NgramCounter *counter) {
+    Analyzer analyzer = { "ngrams", counter, ngram_counter_process_song, ngram_counter_clone, ngram_counter_merge };
+    return analyzer;
+}
+
+// Ordena as entradas da troca por dono e, dentro do dono, por hash
+static int compare_entries(const void *a, const void *b) {
+    const NgramEntry *x = (const NgramEntry*)a;
+    const NgramEntry *y = (const NgramEntry*)b;
+    if (x->owner != y->owner) return x->owner - y->owner;
+    return (x->hash > y->hash) - (x->hash < y->hash);
+}
+
+// Insere a entrada no top-K (maior contagem primeiro; empates pelo menor hash)
+static void offer_top(NgramSlot *top, int *n, uint64_t hash, uint32_t count) {
+    int pos = *n;
+    while (pos > 0 && (top[pos - 1].count < count ||
+                       (top[pos - 1].count == count && top[pos - 1].hash > hash))) {
+        pos--;
+    }
+    if (pos >= TOP_K) return;
+    int last = (*n < TOP_K) ? *n : TOP_K - 1;
+    memmove(&top[pos + 1], &top[pos], (last - pos) * sizeof(NgramSlot));
+    top[pos].hash = hash;
+    top[pos].count = count;
+    top[pos].text = 0;
+    if (*n < TOP_K) (*n)++;
+}
+
+// Junta as contagens de todos os processos no processo 0
+void ngram_counter_reduce(const NgramCounter *counter, NgramCount **ngram_counts, long long *num_ngrams, int world_rank, int world_size) {
+    // 1. Entradas ordenadas por dono e hash: hashes próximos viram diferenças pequenas
+    NgramEntry *entries = malloc((counter->size > 0 ? counter->size : 1) * sizeof(NgramEntry));
+    size_t num_entries = 0;
+    for (size_t i = 0; i < counter->capacity; i++) {
+        const NgramSlot *slot = &counter->slots[i];
+        if (slot->hash == 0) continue;
+        entries[num_entries].hash = slot->hash;
+        entries[num_entries].count = slot->count;
+        entries[num_entries].owner = count_exchange_owner(slot->hash, world_size);
+        num_entries++;
+    }
+    qsort(entries, num_entries, sizeof(NgramEntry), compare_entries);
+
+    // 2. Baldes por dono: [varint diferença do hash anterior][varint contagem]
+    int *send_counts = calloc(world_size, sizeof(int));
+    int *send_displs = malloc(world_size * sizeof(int));
+    int *recv_counts = malloc(world_size * sizeof(int));
+    int *recv_displs = malloc(world_size * sizeof(int));
+    char *send_buffer = malloc(num_entries * 20 + 1);  // Dois varints de até 10 bytes
+    int send_total = 0;
+    uint64_t previous = 0;
+    for (size_t i = 0; i < num_entries; i++) {
+        if (i == 0 || entries[i].owner != entries[i - 1].owner) previous = 0;
+        int written = (int)count_codec_put_varint(send_buffer + send_total, entries[i].hash - previous);
+        written += (int)count_codec_put_varint(send_buffer + send_total + written, entries[i].count);
+        send_counts[entries[i].owner] += written;
+        send_total += written;
+        previous = entries[i].hash;
+    }
+    free(entries);
+    int displ = 0;
+    for (int proc = 0; proc < world_size; proc++) {
+        send_displs[proc] = displ;
+        displ += send_counts[proc];
+    }
+
+    // 3. Troca os baldes: cada processo recebe apenas os hashes que lhe pertencem
+    MPI_Alltoall(send_counts, 1, MPI_INT, recv_counts, 1, MPI_INT, MPI_COMM_WORLD);
+    int recv_total = 0;
+    for (int proc = 0; proc < world_size; proc++) {
+        recv_displs[proc] = recv_total;
+        recv_total += recv_counts[proc];
+    }
+    char *recv_buffer = malloc(recv_total > 0 ? recv_total : 1);
+    MPI_Alltoallv(send_buffer, send_counts, send_displs, MPI_BYTE,
+                  recv_buffer, recv_counts, recv_displs, MPI_BYTE, MPI_COMM_WORLD);
+    free(send_buffer);
+    rank_stats_add(STAT_BYTES_SENT, send_total - send_counts[world_rank]);
+
+    // 4. Reduz a faixa própria (as diferenças recomeçam em cada balde recebido)
+    StatActivity activity = rank_stats_enter(STAT_MERGE);
+    NgramCounter *owned = ngram_counter_create(counter->n);
+    for (int proc = 0; proc < world_size; proc++) {
+        const char *p = recv_buffer + recv_displs[proc];
+        const char *end = p + recv_counts[proc];
+        uint64_t hash = 0;
+        while (p < end) {
+            uint64_t delta, count;
+            size_t used = count_codec_get_varint(p, end, &delta);
+            if (used == 0) break;
+            p += used;
+            used = count_codec_get_varint(p, end, &count);
+            if (used == 0) break;
+            p += used;
+            hash += delta;
+            add_hash(owned, hash, (uint32_t)count);
+        }
+    }
+    free(recv_buffer);
+
+    // 5. Cada dono seleciona o seu top-K
+    NgramSlot top[TOP_K];
+    int num_top = 0;
+    memset(top, 0, sizeof(top));
+    for (size_t i = 0; i < owned->capacity; i++) {
+        if (owned->slots[i].hash != 0) offer_top(top, &num_top, owned->slots[i].hash, owned->slots[i].count);
+    }
+    long long owned_keys = (long long)owned->size;
+    ngram_counter_free(owned);
+    rank_stats_enter(activity);
+
+    // 6. O processo 0 recebe os top-K (chaves disjuntas, contagens exatas) e o total de distintas
+    MPI_Reduce(&owned_keys, num_ngrams, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    NgramSlot *all_top = NULL;
+    if (world_rank == 0) all_top = malloc((size_t)world_size * TOP_K * sizeof(NgramSlot));
+    MPI_Gather(top, TOP_K * sizeof(NgramSlot), MPI_BYTE, all_top, TOP_K * sizeof(NgramSlot), MPI_BYTE, 0, MPI_COMM_WORLD);
+    if (world_rank != 0) rank_stats_add(STAT_BYTES_SENT, TOP_K * sizeof(NgramSlot));
+
+    uint64_t survivors[TOP_K];
+    memset(survivors, 0, sizeof(survivors));
+    NgramCount *out = NULL;
+    if (world_rank == 0) {
+        int num_global = 0;
+        NgramSlot global[TOP_K];
+        for (int i = 0; i < world_size * TOP_K; i++) {
+            if (all_top[i].hash != 0) offer_top(global, &num_global, all_top[i].hash, all_top[i].count);
+        }
+        free(all_top);
+        out = (NgramCount*)calloc(TOP_K, sizeof(NgramCount));
+        for (int i = 0; i < num_global; i++) {
+            out[i].hash = global[i].hash;
+            out[i].count = (int)global[i].count;
+            survivors[i] = global[i].hash;
+        }
+    }
+
+    // 7. Só os textos dos K sobreviventes são pedidos: cada processo envia os que guardou
+    MPI_Bcast(survivors, TOP_K, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+    char *texts = malloc(TOP_K * count_codec_entry_size(NGRAM_MAX_TEXT, TOP_K));
+    int text_bytes = 0;
+    for (int i = 0; i < TOP_K; i++) {
+        if (survivors[i] == 0) continue;
+        const NgramSlot *slot = find_hash(counter, survivors[i]);
+        if (!slot || slot->text == 0) continue;
+        const char *text = counter->texts + slot->text - 1;
+        text_bytes += (int)count_codec_write_entry(texts + text_bytes, text, strlen(text), (uint64_t)i);
+    }
+    int all_bytes;
+    char *all_texts = count_exchange_gather_bytes(texts, text_bytes, &all_bytes, 0, MPI_COMM_WORLD);
+    free(texts);
+
+    if (world_rank == 0) {
+        const char *p = all_texts;
+        const char *end = all_texts + all_bytes;
+        const char *key;
+        size_t key_len;
+        uint64_t index;
+        while (count_codec_next(&p, end, &key, &key_len, &index) == 1) {
+            if (index < TOP_K && out[index].text[0] == '\0' && key_len < NGRAM_MAX_TEXT) {
+                memcpy(out[index].text, key, key_len);
+                out[index].text[key_len] = '\0';
+            }
+        }
+        free(all_texts);
+        for (int i = 0; i < TOP_K && out[i].count > 0; i++) {
+            // Nenhum processo viu o n-grama NGRAM_TEXT_MIN_COUNT vezes: mostra o hash
+            if (out[i].text[0] == '\0') {
+                snprintf(out[i].text, NGRAM_MAX_TEXT, "#%016llx", (unsigned long long)out[i].hash);
+            }
+        }
+        *ngram_counts = out;
+
+        printf(": %d-gram counting completed. Found %lld unique %d-grams.\n", counter->n, *num_ngrams, counter->n);
+        printf("Top 10 most frequent %d-grams:\n", counter->n);
+        for (int i = 0; i < TOP_K && out[i].count > 0; i++) {
+            printf("  %d. %s: %d occurrences\n", i + 1, out[i].text, out[i].count);
+        }
+    }
+
+    free(send_counts);
+    free(send_displs);
+    free(recv_counts);
+    free(recv_displs);
+}
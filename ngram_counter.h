@@ -0,0 +1,88 @@
+#ifndef NGRAM_COUNTER_H
+#define NGRAM_COUNTER_H
+
+// Inclusão das bibliotecas necessárias
+#include <stddef.h>        // Para size_t
+#include <stdint.h>        // Para inteiros de tamanho fixo
+#include "analyzer.h"      // Para Analyzer, SongView e TOP_K
+#include "tokenizer.h"     // Para TOKENIZER_MAX_WORD
+
+// Limites dos n-gramas
+#define NGRAM_MIN_N 2                  // Menor n aceito (n = 1 é o contador de palavras)
+#define NGRAM_MAX_N 5                  // Maior n aceito
+#define NGRAM_MAX_TEXT (NGRAM_MAX_N * (TOKENIZER_MAX_WORD + 1))  // Texto de um n-grama com os espaços
+#define NGRAM_TABLE_INITIAL_KEYS 16384 // Estimativa inicial de n-gramas distintos (a tabela cresce)
+#define NGRAM_TEXT_MIN_COUNT 2         // Contagem local a partir da qual o texto do n-grama é guardado
+
+// Entrada da tabela: só o hash de 64 bits da sequência de palavras, sem a chave em texto
+typedef struct {
+    uint64_t hash;    // Hash da sequência (0 = entrada vazia)
+    uint32_t count;   // Contagem acumulada
+    uint32_t text;    // Posição + 1 do texto na tabela lateral (0 = texto não guardado)
+} NgramSlot;
+
+// Contador de n-gramas (sequências de n palavras consecutivas da mesma letra).
+// As chaves têm largura fixa (hash de 64 bits, 16 bytes por entrada com a contagem);
+// o texto só é guardado, numa tabela lateral, quando a contagem local chega a
+// NGRAM_TEXT_MIN_COUNT, o que descarta a maioria dos n-gramas (que aparecem uma vez)
+typedef struct {
+    int n;                    // Palavras por n-grama
+    NgramSlot *slots;         // Vetor de entradas (capacidade potência de 2)
+    size_t capacity;          // Número de entradas do vetor
+    size_t size;              // Número de n-gramas distintos
+    char *texts;              // Tabela lateral: textos terminados em '\0'
+    size_t texts_used;        // Bytes ocupados na tabela lateral
+    size_t texts_capacity;    // Bytes alocados para a tabela lateral
+    long long total;          // Total de n-gramas contados
+    // Janela das últimas n palavras da música atual (vetor circular)
+    uint64_t window_hashes[NGRAM_MAX_N];
+    char window_words[NGRAM_MAX_N][TOKENIZER_MAX_WORD + 1];
+    int window_lens[NGRAM_MAX_N];
+    int window_fill;          // Palavras da música atual já vistas (até n)
+    int window_next;          // Posição da próxima palavra no vetor circular
+} NgramCounter;
+
+// Estrutura para armazenar contagem de n-gramas no resultado
+typedef struct {
+    char text[NGRAM_MAX_TEXT];  // Palavras separadas por espaço ("#hash" se nenhum processo guardou o texto)
+    uint64_t hash;              // Hash da sequência
+    int count;                  // Quantas vezes o n-grama aparece
+} NgramCount;
+
+// Declarações das funções
+
+/**
+ * Cria um contador de n-gramas vazio
+ * @param n Palavras por n-grama (NGRAM_MIN_N a NGRAM_MAX_N)
+ * @return Ponteiro para NgramCounter alocado
+ */
+NgramCounter* ngram_counter_create(int n);
+
+/**
+ * Libera a memória do contador de n-gramas
+ * @param counter Ponteiro para NgramCounter a ser liberado
+ */
+void ngram_counter_free(NgramCounter *counter);
+
+/**
+ * Monta o analisador que alimenta o contador de n-gramas (na mesma passada das palavras)
+ * @param counter Contador a ser alimentado
+ * @return Analisador pronto para a passada sobre o CSV
+ */
+Analyzer ngram_counter_analyzer(NgramCounter *counter);
+
+/**
+ * Junta as contagens de todos os processos e imprime o top 10 no processo 0:
+ * as chaves são particionadas por hash entre os processos (MPI_Alltoallv, hashes
+ * ordenados e codificados como diferenças em varint), cada dono envia o seu top-K
+ * ao processo 0 e só os textos dos K sobreviventes são pedidos aos processos
+ * @param counter Contador local deste processo (não é alterado)
+ * @param ngram_counts Saída no processo 0: vetor alocado com TOP_K posições, ordenado por
+ *                     contagem (posições sem n-grama ficam com contagem 0); NULL nos demais
+ * @param num_ngrams Saída no processo 0: número total de n-gramas distintos
+ * @param world_rank ID do processo atual
+ * @param world_size Número total de processos
+ */
+void ngram_counter_reduce(const NgramCounter *counter, NgramCount **ngram_counts, long long *num_ngrams, int world_rank, int world_size);
+
+#endif // NGRAM_COUNTER_H
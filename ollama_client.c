@@ -3,12 +3,6 @@
 
 // Constantes para configuração do Ollama
 #define OLLAMA_URL "http://localhost:11434"  // URL do servidor Ollama local
-#define OLLAMA_MODEL_NAME "wizard-vicuna-uncensored:7b"  // Nome do modelo de IA a ser usado
-#define OLLAMA_PRE_PROMPT "You are a sentiment classifier for song lyrics. " \
-                         "Analyze the provided lyrics and classify the sentiment as: " \
-                         "0: \"Positive\", 1: \"Neutral\" or 2: \"Negative\". " \
-                         "Answer ONLY with one of these three numbers, use only one number without additional explanations or words your awnsware needs to be only one character long.\n\n" \
-                         "Lyrics to classify:\n"  // Prompt pré-definido para classificação de sentimento
 
 // Função callback para libcurl escrever dados de resposta
 static size_t write_callback(void *contents, size_t size, size_t nmemb, void *userp) {
@@ -70,6 +64,89 @@ OllamaRequest* ollama_request_init_classification(const char *model, const char
     return request;
 }
 
+// Tamanho do prompt de um lote (sem o '\0' final)
+static size_t batch_prompt_size(char **lyrics, int count) {
+    size_t size = strlen(OLLAMA_BATCH_PRE_PROMPT);
+    for (int i = 0; i < count; i++) {
+        size += snprintf(NULL, 0, OLLAMA_BATCH_SONG_HEADER, i + 1) + strlen(lyrics[i]) + 2;
+    }
+    return size;
+}
+
+// Escreve o prompt de um lote: instruções seguidas de cada letra com seu id (1..count)
+static void write_batch_prompt(char *dst, char **lyrics, int count) {
+    char *p = dst;
+    p += sprintf(p, "%s", OLLAMA_BATCH_PRE_PROMPT);
+    for (int i = 0; i < count; i++) {
+        p += sprintf(p, OLLAMA_BATCH_SONG_HEADER, i + 1);
+        p += sprintf(p, "%s\n\n", lyrics[i]);
+    }
+}
+
+// Inicializa uma requisição que classifica várias letras de uma vez, com saída JSON
+OllamaRequest* ollama_request_init_batch_classification(const char *model, char **lyrics, int count) {
+    OllamaRequest *request = malloc(sizeof(OllamaRequest));
+    request->model = strdup(model);                 // Nome do modelo a ser usado
+    request->stream = 0;                            // Não usar streaming
+    request->format = strdup(OLLAMA_BATCH_FORMAT);  // Esquema JSON da resposta
+    
+    request->prompt = malloc(batch_prompt_size(lyrics, count) + 1);
+    write_batch_prompt(request->prompt, lyrics, count);
+    return request;
+}
+
+// Lê a resposta de um lote: {"results": [{"id": N, "label": L}, ...]}, aceitando também
+// um vetor solto, texto em volta do JSON e itens faltando ou repetidos
+int ollama_parse_batch_labels(const char *text, int count, int *labels) {
+    for (int i = 0; i < count; i++) labels[i] = -1;
+    if (!text) return 0;
+    
+    // Tenta o texto inteiro; se houver texto em volta, tenta a partir de cada '{' ou '['
+    struct json_object *root = json_tokener_parse(text);
+    for (const char *start = strpbrk(text, "{["); !root && start; start = strpbrk(start + 1, "{[")) {
+        root = json_tokener_parse(start);
+    }
+    if (!root) return 0;
+    
+    // Localiza o vetor de resultados
+    struct json_object *items = NULL;
+    if (json_object_is_type(root, json_type_array)) {
+        items = root;
+    } else if (json_object_is_type(root, json_type_object) &&
+               json_object_object_get_ex(root, "results", &items) &&
+               !json_object_is_type(items, json_type_array)) {
+        items = NULL;
+    }
+    
+    int found = 0;
+    size_t n = items ? json_object_array_length(items) : 0;
+    for (size_t i = 0; i < n; i++) {
+        struct json_object *item = json_object_array_get_idx(items, i);
+        struct json_object *id_obj, *label_obj;
+        int id, label;
+        
+        if (json_object_is_type(item, json_type_object) &&
+            json_object_object_get_ex(item, "id", &id_obj) &&
+            json_object_object_get_ex(item, "label", &label_obj)) {
+            id = json_object_get_int(id_obj);        // Aceita também "3" como string
+            label = json_object_get_int(label_obj);
+        } else if (json_object_is_type(item, json_type_int)) {
+            id = (int)i + 1;                         // Vetor de rótulos na ordem das músicas
+            label = json_object_get_int(item);
+        } else {
+            continue;
+        }
+        
+        if (id >= 1 && id <= count && label >= 0 && label <= 2 && labels[id - 1] < 0) {
+            labels[id - 1] = label;
+            found++;
+        }
+    }
+    
+    json_object_put(root);
+    return found;
+}
+
 // Libera a memória alocada para uma requisição do Ollama
 void ollama_request_free(OllamaRequest *request) {
     if (request) {
@@ -103,16 +180,9 @@ void ollama_response_free(OllamaResponse *response) {
     }
 }
 
-// Envia uma requisição para o Ollama e obtém a resposta
-int ollama_send_request(const OllamaConfig *config, 
-                       const OllamaRequest *request, 
-                       OllamaResponse *response) {
-    CURL *curl;  // Handle do libcurl
-    CURLcode res;  // Código de resultado do curl
+// Monta o corpo JSON de uma requisição (o chamador libera com json_object_put)
+static struct json_object* build_request_json(const OllamaRequest *request) {
     struct json_object *json_obj, *model_obj, *prompt_obj, *stream_obj;  // Objetos JSON
-    char *json_string;  // String JSON final
-    
-    curl = curl_easy_init();  // Inicializa o curl
     
     // Cria a requisição JSON
     json_obj = json_object_new_object();  // Objeto JSON principal
@@ -127,11 +197,71 @@ int ollama_send_request(const OllamaConfig *config,
     
     // Adiciona formato se especificado
     if (request->format) {
-        struct json_object *format_obj = json_object_new_string(request->format);
+        // Um esquema JSON vai como objeto; qualquer outro valor (ex: "json") vai como string
+        struct json_object *format_obj = (request->format[0] == '{') ? json_tokener_parse(request->format) : NULL;
+        if (!format_obj) format_obj = json_object_new_string(request->format);
         json_object_object_add(json_obj, "format", format_obj);
     }
     
-    // Converte o objeto JSON para string
+    return json_obj;
+}
+
+// Substitui o corpo bruto recebido pelos campos da resposta JSON do Ollama
+static void parse_response(OllamaResponse *response) {
+    if (!response->response) return;
+    
+    struct json_object *response_json = json_tokener_parse(response->response);
+    if (response_json) {
+        struct json_object *response_text, *model_name, *done_flag, *error_msg;
+        
+        // Extrai o texto da resposta
+        if (json_object_object_get_ex(response_json, "response", &response_text)) {
+            const char *text = json_object_get_string(response_text);
+            if (text) {
+                free(response->response);  // Libera a resposta original
+                response->response = strdup(text);  // Salva apenas o texto
+                response->response_len = strlen(text);
+            }
+        }
+        
+        // Extrai o nome do modelo usado
+        if (json_object_object_get_ex(response_json, "model", &model_name)) {
+            const char *model = json_object_get_string(model_name);
+            if (model) {
+                response->model = strdup(model);
+            }
+        }
+        
+        // Extrai a flag de conclusão
+        if (json_object_object_get_ex(response_json, "done", &done_flag)) {
+            response->done = json_object_get_boolean(done_flag);
+        }
+        
+        // Extrai mensagem de erro se existir
+        if (json_object_object_get_ex(response_json, "error", &error_msg)) {
+            const char *error = json_object_get_string(error_msg);
+            if (error) {
+                response->error = strdup(error);
+            }
+        }
+        
+        json_object_put(response_json);  // Libera o objeto JSON da resposta
+    }
+}
+
+// Envia uma requisição para o Ollama e obtém a resposta
+int ollama_send_request(const OllamaConfig *config, 
+                       const OllamaRequest *request, 
+                       OllamaResponse *response) {
+    CURL *curl;  // Handle do libcurl
+    CURLcode res;  // Código de resultado do curl
+    struct json_object *json_obj;  // Objeto JSON da requisição
+    char *json_string;  // String JSON final
+    
+    curl = curl_easy_init();  // Inicializa o curl
+    
+    // Cria a requisição JSON e converte para string
+    json_obj = build_request_json(request);
     json_string = (char *)json_object_to_json_string(json_obj);
     
     // Configura as opções do curl
@@ -161,45 +291,7 @@ int ollama_send_request(const OllamaConfig *config,
     }
     
     // Analisa a resposta JSON
-    if (response->response) {
-        struct json_object *response_json = json_tokener_parse(response->response);
-        if (response_json) {
-            struct json_object *response_text, *model_name, *done_flag, *error_msg;
-            
-            // Extrai o texto da resposta
-            if (json_object_object_get_ex(response_json, "response", &response_text)) {
-                const char *text = json_object_get_string(response_text);
-                if (text) {
-                    free(response->response);  // Libera a resposta original
-                    response->response = strdup(text);  // Salva apenas o texto
-                    response->response_len = strlen(text);
-                }
-            }
-            
-            // Extrai o nome do modelo usado
-            if (json_object_object_get_ex(response_json, "model", &model_name)) {
-                const char *model = json_object_get_string(model_name);
-                if (model) {
-                    response->model = strdup(model);
-                }
-            }
-            
-            // Extrai a flag de conclusão
-            if (json_object_object_get_ex(response_json, "done", &done_flag)) {
-                response->done = json_object_get_boolean(done_flag);
-            }
-            
-            // Extrai mensagem de erro se existir
-            if (json_object_object_get_ex(response_json, "error", &error_msg)) {
-                const char *error = json_object_get_string(error_msg);
-                if (error) {
-                    response->error = strdup(error);
-                }
-            }
-            
-            json_object_put(response_json);  // Libera o objeto JSON da resposta
-        }
-    }
+    parse_response(response);
     
     curl_easy_cleanup(curl);  // Limpa o handle do curl
     json_object_put(json_obj);  // Libera o objeto JSON da requisição
@@ -207,20 +299,336 @@ int ollama_send_request(const OllamaConfig *config,
     return 0;  // Sucesso
 }
 
+// Inicialização global do libcurl, feita uma única vez por processo
+static int curl_initialized = 0;
+static OllamaSession *default_session = NULL;  // Sessão usada por classify_lyrics
+
+void ollama_global_init(void) {
+    if (!curl_initialized) {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+        curl_initialized = 1;
+    }
+}
+
+void ollama_global_cleanup(void) {
+    ollama_session_free(default_session);
+    default_session = NULL;
+    if (curl_initialized) {
+        curl_global_cleanup();
+        curl_initialized = 0;
+    }
+}
+
+// Garante espaço para 'needed' bytes num buffer reaproveitado (crescimento geométrico)
+static int reserve_buffer(char **buffer, size_t *capacity, size_t needed) {
+    if (needed <= *capacity) return 0;
+    size_t new_capacity = *capacity ? *capacity : 1024;
+    while (new_capacity < needed) new_capacity *= 2;
+    char *ptr = realloc(*buffer, new_capacity);
+    if (!ptr) return -1;
+    *buffer = ptr;
+    *capacity = new_capacity;
+    return 0;
+}
+
+// Callback do libcurl que acumula a resposta no buffer bruto da sessão
+static size_t session_write_callback(void *contents, size_t size, size_t nmemb, void *userp) {
+    size_t realsize = size * nmemb;
+    OllamaSession *session = (OllamaSession *)userp;
+    
+    if (reserve_buffer(&session->raw, &session->raw_capacity, session->raw_len + realsize + 1) != 0) {
+        fprintf(stderr, "Erro de alocação de memória\n");
+        return 0;
+    }
+    memcpy(session->raw + session->raw_len, contents, realsize);
+    session->raw_len += realsize;
+    session->raw[session->raw_len] = 0;
+    return realsize;
+}
+
+// Cria uma sessão persistente com um servidor Ollama
+OllamaSession* ollama_session_create(const char *url) {
+    ollama_global_init();
+    
+    OllamaSession *session = calloc(1, sizeof(OllamaSession));
+    snprintf(session->endpoint, sizeof(session->endpoint), "%s/api/generate", url ? url : OLLAMA_DEFAULT_URL);
+    session->curl = curl_easy_init();
+    session->tokener = json_tokener_new();
+    
+    // Os campos fixos do corpo são montados uma vez; só o prompt muda a cada chamada
+    session->body = json_object_new_object();
+    json_object_object_add(session->body, "model", json_object_new_string(OLLAMA_MODEL_NAME));
+    json_object_object_add(session->body, "stream", json_object_new_boolean(0));
+    
+    // Opções que não mudam entre as requisições
+    curl_easy_setopt(session->curl, CURLOPT_URL, session->endpoint);
+    curl_easy_setopt(session->curl, CURLOPT_WRITEFUNCTION, session_write_callback);
+    curl_easy_setopt(session->curl, CURLOPT_WRITEDATA, session);
+    curl_easy_setopt(session->curl, CURLOPT_TIMEOUT, 30L);  // Timeout de 30 segundos
+    curl_easy_setopt(session->curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(session->curl, CURLOPT_PRIVATE, session);
+    return session;
+}
+
+// Libera a sessão, fechando a conexão mantida
+void ollama_session_free(OllamaSession *session) {
+    if (session) {
+        curl_easy_cleanup(session->curl);
+        json_object_put(session->body);
+        json_tokener_free(session->tokener);
+        free(session->prompt);
+        free(session->raw);
+        free(session->text);
+        free(session);
+    }
+}
+
+// Prepara o handle da sessão para uma requisição (sem enviá-la)
+static void session_prepare(OllamaSession *session, const char *prompt, int batch_format) {
+    // Substitui apenas o prompt; o json-c reaproveita o buffer de serialização do objeto
+    json_object_object_add(session->body, "prompt", json_object_new_string(prompt));
+    
+    // O esquema da resposta em lote só é (re)colocado quando o tipo de requisição muda
+    if (batch_format && !session->has_format) {
+        json_object_object_add(session->body, "format", json_tokener_parse(OLLAMA_BATCH_FORMAT));
+    } else if (!batch_format && session->has_format) {
+        json_object_object_del(session->body, "format");
+    }
+    session->has_format = batch_format;
+    size_t body_len;
+    const char *body = json_object_to_json_string_length(session->body, JSON_C_TO_STRING_PLAIN, &body_len);
+    
+    curl_easy_setopt(session->curl, CURLOPT_POSTFIELDS, body);
+    curl_easy_setopt(session->curl, CURLOPT_POSTFIELDSIZE, (long)body_len);
+    session->raw_len = 0;
+}
+
+// Extrai o texto da resposta bruta recebida; NULL se a requisição falhou
+static const char* session_finish(OllamaSession *session, CURLcode res) {
+    if (res != CURLE_OK) {
+        fprintf(stderr, "Erro na requisição ao Ollama: %s\n", curl_easy_strerror(res));
+        return NULL;
+    }
+    if (session->raw_len == 0) return NULL;
+    
+    json_tokener_reset(session->tokener);
+    struct json_object *response_json = json_tokener_parse_ex(session->tokener, session->raw, (int)session->raw_len);
+    if (!response_json) return NULL;
+    
+    const char *result = NULL;
+    struct json_object *response_text;
+    if (json_object_object_get_ex(response_json, "response", &response_text)) {
+        const char *text = json_object_get_string(response_text);
+        if (text) {
+            size_t len = strlen(text);
+            if (reserve_buffer(&session->text, &session->text_capacity, len + 1) == 0) {
+                memcpy(session->text, text, len + 1);
+                result = session->text;
+            }
+        }
+    }
+    json_object_put(response_json);
+    return result;
+}
+
+// Monta o prompt de classificação no buffer reaproveitado da sessão
+static const char* session_classification_prompt(OllamaSession *session, const char *lyrics) {
+    size_t pre_prompt_len = strlen(OLLAMA_PRE_PROMPT);
+    size_t lyrics_len = strlen(lyrics);
+    if (reserve_buffer(&session->prompt, &session->prompt_capacity, pre_prompt_len + lyrics_len + 1) != 0) {
+        return NULL;
+    }
+    memcpy(session->prompt, OLLAMA_PRE_PROMPT, pre_prompt_len);
+    memcpy(session->prompt + pre_prompt_len, lyrics, lyrics_len + 1);
+    return session->prompt;
+}
+
+// Monta o prompt de um lote no buffer reaproveitado da sessão
+static const char* session_batch_prompt(OllamaSession *session, char **lyrics, int count) {
+    if (reserve_buffer(&session->prompt, &session->prompt_capacity, batch_prompt_size(lyrics, count) + 1) != 0) {
+        return NULL;
+    }
+    write_batch_prompt(session->prompt, lyrics, count);
+    return session->prompt;
+}
+
+// Converte o texto devolvido pelo modelo numa classificação (0, 1, 2) ou -1
+static int parse_label(const char *text) {
+    if (!text) return -1;
+    int classification = atoi(text);
+    return (classification >= 0 && classification <= 2) ? classification : -1;
+}
+
+// Envia um prompt pela sessão e devolve o texto gerado
+const char* ollama_session_generate(OllamaSession *session, const char *prompt) {
+    session_prepare(session, prompt, 0);
+    return session_finish(session, curl_easy_perform(session->curl));
+}
+
+// Classifica o sentimento de uma letra pela sessão
+int ollama_session_classify(OllamaSession *session, const char *lyrics) {
+    const char *prompt = session_classification_prompt(session, lyrics);
+    if (!prompt) return -1;
+    return parse_label(ollama_session_generate(session, prompt));
+}
+
+// Classifica várias letras numa única requisição com saída JSON
+int ollama_session_classify_batch(OllamaSession *session, char **lyrics, int count, int *labels) {
+    const char *prompt = session_batch_prompt(session, lyrics, count);
+    if (!prompt) {
+        for (int i = 0; i < count; i++) labels[i] = -1;
+        return 0;
+    }
+    session_prepare(session, prompt, 1);
+    return ollama_parse_batch_labels(session_finish(session, curl_easy_perform(session->curl)), count, labels);
+}
+
 // Função simplificada para classificar o sentimento das letras de música
 char* classify_lyrics(const char *lyrics) {
-    OllamaConfig *config = ollama_config_init();  // Inicializa configuração
-    OllamaRequest *request = ollama_request_init_classification(OLLAMA_MODEL_NAME, lyrics);  // Cria requisição
-    OllamaResponse *response = ollama_response_init();  // Inicializa resposta
+    // Usa a sessão padrão do processo: a conexão é reaproveitada entre as chamadas
+    if (!default_session) {
+        default_session = ollama_session_create(NULL);
+    }
+    
+    const char *prompt = session_classification_prompt(default_session, lyrics);
+    const char *result = prompt ? ollama_session_generate(default_session, prompt) : NULL;
+    return result ? strdup(result) : NULL;  // Copia o resultado
+}
+
+// Classifica várias letras mantendo até max_in_flight requisições simultâneas
+int classify_lyrics_concurrent(char **lyrics, int count, const char *const *urls, int num_urls, int max_in_flight, int batch_size, int *labels, int *batched) {
+    // Uma sessão por requisição simultânea, distribuídas em rodízio entre os servidores;
+    // cada servidor recebe ao menos uma conexão
+    if (max_in_flight < num_urls) max_in_flight = num_urls;
+    if (max_in_flight < 1) max_in_flight = 1;
+    if (batch_size < 1) batch_size = 1;
+    
+    OllamaSession **sessions = malloc(max_in_flight * sizeof(OllamaSession*));
+    int *slot_songs = malloc(max_in_flight * batch_size * sizeof(int));  // Músicas em andamento em cada sessão
+    int *slot_count = calloc(max_in_flight, sizeof(int));                // 0 = sessão livre
+    int *slot_batch = calloc(max_in_flight, sizeof(int));                // Se a requisição é um lote
+    for (int s = 0; s < max_in_flight; s++) {
+        sessions[s] = ollama_session_create(num_urls > 0 ? urls[s % num_urls] : NULL);
+    }
     
-    ollama_send_request(config, request, response);  // Envia requisição
+    // Fila circular das músicas a enviar; itens que faltarem numa resposta voltam para ela
+    int *queue = malloc((count > 0 ? count : 1) * sizeof(int));
+    int *attempts = calloc(count > 0 ? count : 1, sizeof(int));  // Lotes em que a música já faltou
+    int head = 0;
+    int queued = count;
+    for (int i = 0; i < count; i++) {
+        queue[i] = i;
+        labels[i] = -1;
+        if (batched) batched[i] = 0;
+    }
+    
+    char **batch_lyrics = malloc(batch_size * sizeof(char*));
+    int *batch_labels = malloc(batch_size * sizeof(int));
+    CURLM *multi = curl_multi_init();
+    int in_flight = 0;   // Requisições em andamento
+    int classified = 0;  // Músicas com classificação válida
     
-    char *result = strdup(response->response);  // Copia o resultado
+    while (queued > 0 || in_flight > 0) {
+        // Ocupa as sessões livres com as próximas músicas da fila
+        for (int s = 0; s < max_in_flight && queued > 0; s++) {
+            if (slot_count[s] > 0) continue;
+            int *songs = slot_songs + s * batch_size;
+            int n = 0;
+            
+            // Música que já faltou OLLAMA_BATCH_MAX_RETRIES vezes vai sozinha, com o prompt simples
+            slot_batch[s] = batch_size > 1 && attempts[queue[head]] < OLLAMA_BATCH_MAX_RETRIES;
+            do {
+                songs[n++] = queue[head];
+                head = (head + 1) % count;
+                queued--;
+            } while (slot_batch[s] && n < batch_size && queued > 0 && attempts[queue[head]] < OLLAMA_BATCH_MAX_RETRIES);
+            
+            const char *prompt;
+            if (slot_batch[s]) {
+                for (int i = 0; i < n; i++) batch_lyrics[i] = lyrics[songs[i]];
+                prompt = session_batch_prompt(sessions[s], batch_lyrics, n);
+            } else {
+                prompt = session_classification_prompt(sessions[s], lyrics[songs[0]]);
+            }
+            if (!prompt) {
+                if (slot_batch[s]) {
+                    // Sem memória para o lote: as músicas voltam para a fila e vão sozinhas, com prompts menores
+                    for (int i = 0; i < n; i++) {
+                        attempts[songs[i]] = OLLAMA_BATCH_MAX_RETRIES;
+                        queue[(head + queued) % count] = songs[i];
+                        queued++;
+                    }
+                } else {
+                    // Nem o prompt simples coube: a música fica como falha
+                    fprintf(stderr, "Erro: não foi possível montar o prompt de classificação\n");
+                    labels[songs[0]] = -1;
+                }
+                continue;
+            }
+
+            session_prepare(sessions[s], prompt, slot_batch[s]);
+            curl_multi_add_handle(multi, sessions[s]->curl);
+            slot_count[s] = n;
+            in_flight++;
+        }
+        
+        int running;
+        curl_multi_perform(multi, &running);
+        
+        // Recolhe as requisições concluídas
+        CURLMsg *msg;
+        int pending;
+        while ((msg = curl_multi_info_read(multi, &pending))) {
+            if (msg->msg != CURLMSG_DONE) continue;
+            
+            OllamaSession *done = NULL;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char **)&done);
+            int s = 0;
+            while (sessions[s] != done) s++;
+            int *songs = slot_songs + s * batch_size;
+            
+            const char *text = session_finish(done, msg->data.result);
+            curl_multi_remove_handle(multi, done->curl);
+            if (slot_batch[s]) {
+                ollama_parse_batch_labels(text, slot_count[s], batch_labels);
+                for (int i = 0; i < slot_count[s]; i++) {
+                    if (batch_labels[i] >= 0) {
+                        labels[songs[i]] = batch_labels[i];
+                        if (batched) batched[songs[i]] = 1;
+                        classified++;
+                    } else {
+                        // Faltou na resposta: volta para a fila
+                        attempts[songs[i]]++;
+                        queue[(head + queued) % count] = songs[i];
+                        queued++;
+                    }
+                }
+            } else {
+                labels[songs[0]] = parse_label(text);
+                if (labels[songs[0]] >= 0) classified++;
+            }
+            slot_count[s] = 0;
+            in_flight--;
+        }
+        
+        // Aguarda atividade nas conexões em vez de girar em falso
+        if (in_flight > 0) {
+            curl_multi_poll(multi, NULL, 0, 1000, NULL);
+        }
+    }
     
-    // Libera toda a memória alocada
-    ollama_response_free(response);
-    ollama_request_free(request);
-    ollama_config_free(config);
+    curl_multi_cleanup(multi);
+    for (int s = 0; s < max_in_flight; s++) {
+        ollama_session_free(sessions[s]);
+    }
+    free(sessions);
+    free(slot_songs);
+    free(slot_count);
+    free(slot_batch);
+    free(queue);
+    free(attempts);
+    free(batch_lyrics);
+    free(batch_labels);
     
-    return result;  // Retorna o resultado da classificação
-}
\ No newline at end of file
+    return classified;
+}
@@ -9,9 +9,33 @@
 #include <string.h>   // Para manipulação de strings
 #include <curl/curl.h>  // Para requisições HTTP
 
+struct json_object;   // Declarações antecipadas dos tipos do json-c
+struct json_tokener;
+
 // Endpoint da API do Ollama (padrão local)
 #define OLLAMA_DEFAULT_URL "http://localhost:11434"
 
+// Modelo e prompt da classificação (também fazem parte da chave do cache de sentimentos)
+#define OLLAMA_MODEL_NAME "wizard-vicuna-uncensored:7b"  // Nome do modelo de IA a ser usado
+#define OLLAMA_PRE_PROMPT "You are a sentiment classifier for song lyrics. " \
+                         "Analyze the provided lyrics and classify the sentiment as: " \
+                         "0: \"Positive\", 1: \"Neutral\" or 2: \"Negative\". " \
+                         "Answer ONLY with one of these three numbers, use only one number without additional explanations or words your awnsware needs to be only one character long.\n\n" \
+                         "Lyrics to classify:\n"  // Prompt pré-definido para classificação de sentimento
+
+// Classificação em lote: várias letras num único prompt, com resposta JSON restrita por esquema
+#define OLLAMA_BATCH_PRE_PROMPT "You are a sentiment classifier for song lyrics. " \
+                               "Classify the sentiment of each song below as 0 (Positive), 1 (Neutral) or 2 (Negative). " \
+                               "Answer ONLY with a JSON object of the form " \
+                               "{\"results\": [{\"id\": <song id>, \"label\": <0, 1 or 2>}, ...]} " \
+                               "with exactly one entry per song.\n\n"
+#define OLLAMA_BATCH_SONG_HEADER "### Song %d\n"  // Cabeçalho de cada letra no prompt do lote
+#define OLLAMA_BATCH_FORMAT "{\"type\":\"object\",\"properties\":{\"results\":{\"type\":\"array\",\"items\":" \
+                            "{\"type\":\"object\",\"properties\":{\"id\":{\"type\":\"integer\"}," \
+                            "\"label\":{\"type\":\"integer\",\"enum\":[0,1,2]}},\"required\":[\"id\",\"label\"]}}}," \
+                            "\"required\":[\"results\"]}"  // Esquema JSON enviado no campo "format"
+#define OLLAMA_BATCH_MAX_RETRIES 2  // Lotes em que uma música pode faltar antes de ir sozinha
+
 // Estrutura para resposta da API do Ollama
 typedef struct {
     char *response;      // O texto da resposta real
@@ -26,7 +50,7 @@ typedef struct {
     char *model;         // Modelo a usar (ex: "llama2", "codellama")
     char *prompt;        // Prompt de entrada
     int stream;          // Se deve fazer streaming da resposta
-    char *format;        // Formato da resposta (opcional)
+    char *format;        // Formato da resposta (opcional): "json" ou um esquema JSON
 } OllamaRequest;
 
 // Estrutura de configuração
@@ -36,8 +60,65 @@ typedef struct {
     int verbose;         // Log verboso
 } OllamaConfig;
 
+// Sessão persistente com um servidor Ollama: o handle curl é mantido vivo (a
+// conexão TCP é reaproveitada) e os buffers de requisição e resposta são
+// reaproveitados entre as chamadas
+typedef struct {
+    CURL *curl;                      // Handle reaproveitado entre as requisições
+    char endpoint[512];              // URL completa de /api/generate
+    struct json_object *body;        // Corpo JSON da requisição (só o prompt muda)
+    struct json_tokener *tokener;    // Parser JSON reaproveitado
+    char *prompt;                    // Buffer do prompt
+    size_t prompt_capacity;
+    char *raw;                       // Corpo bruto da última resposta
+    size_t raw_len;
+    size_t raw_capacity;
+    char *text;                      // Texto da última resposta extraído do JSON
+    size_t text_capacity;
+    int has_format;                  // Se o corpo contém o esquema da resposta em lote
+} OllamaSession;
+
 // Declarações das funções
 
+/**
+ * Inicializa o libcurl uma única vez por processo (chamar antes de criar threads)
+ */
+void ollama_global_init(void);
+
+/**
+ * Libera a sessão padrão e finaliza o libcurl
+ */
+void ollama_global_cleanup(void);
+
+/**
+ * Cria uma sessão persistente com um servidor Ollama
+ * @param url URL do servidor (NULL para o servidor padrão)
+ * @return Ponteiro para OllamaSession alocada
+ */
+OllamaSession* ollama_session_create(const char *url);
+
+/**
+ * Libera a sessão, fechando a conexão mantida
+ * @param session Ponteiro para OllamaSession a ser liberada
+ */
+void ollama_session_free(OllamaSession *session);
+
+/**
+ * Envia um prompt pela sessão e devolve o texto gerado
+ * @param session Sessão persistente
+ * @param prompt Prompt completo
+ * @return Texto da resposta (pertence à sessão e vale até a próxima chamada), ou NULL em caso de erro
+ */
+const char* ollama_session_generate(OllamaSession *session, const char *prompt);
+
+/**
+ * Classifica o sentimento de uma letra pela sessão
+ * @param session Sessão persistente
+ * @param lyrics Letras da música a classificar
+ * @return 0 (Positivo), 1 (Neutro), 2 (Negativo), ou -1 em caso de erro
+ */
+int ollama_session_classify(OllamaSession *session, const char *lyrics);
+
 /**
  * Inicializa a configuração do Ollama com valores padrão
  * @return Ponteiro para estrutura OllamaConfig alocada
@@ -88,10 +169,59 @@ int ollama_send_request(const OllamaConfig *config,
 OllamaRequest* ollama_request_init_classification(const char *model, const char *lyrics);
 
 /**
- * Função simplificada para classificar o sentimento das letras
+ * Inicializa requisição que classifica várias letras de uma vez, pedindo a resposta
+ * no esquema JSON OLLAMA_BATCH_FORMAT (campo format)
+ * @param model Nome do modelo a usar
+ * @param lyrics Letras das músicas (identificadas no prompt por 1..count)
+ * @param count Número de músicas
+ * @return Ponteiro para estrutura OllamaRequest alocada
+ */
+OllamaRequest* ollama_request_init_batch_classification(const char *model, char **lyrics, int count);
+
+/**
+ * Lê a resposta de um lote. Aceita o objeto {"results": [...]}, um vetor solto e texto
+ * em volta do JSON; itens com id desconhecido, repetidos ou rótulo inválido são ignorados
+ * @param text Texto devolvido pelo modelo
+ * @param count Número de músicas do lote
+ * @param labels Saída: classificação de cada música, ou -1 se ela faltou na resposta
+ * @return Número de músicas classificadas
+ */
+int ollama_parse_batch_labels(const char *text, int count, int *labels);
+
+/**
+ * Classifica várias letras numa única requisição pela sessão
+ * @param session Sessão persistente
+ * @param lyrics Letras das músicas
+ * @param count Número de músicas
+ * @param labels Saída: classificação de cada música, ou -1 se ela faltou na resposta
+ * @return Número de músicas classificadas
+ */
+int ollama_session_classify_batch(OllamaSession *session, char **lyrics, int count, int *labels);
+
+/**
+ * Função simplificada para classificar o sentimento das letras (usa a sessão padrão do processo)
  * @param lyrics Letras da música a classificar
- * @return Resultado da classificação: "0" (Positivo), "1" (Neutro), ou "2" (Negativo)
+ * @return Resultado da classificação: "0" (Positivo), "1" (Neutro), ou "2" (Negativo); NULL em caso de erro
  */
 char* classify_lyrics(const char *lyrics);
 
+/**
+ * Classifica o sentimento de várias letras usando a interface multi do libcurl,
+ * mantendo até max_in_flight sessões persistentes com requisições simultâneas
+ * @param lyrics Letras das músicas a classificar
+ * @param count Número de músicas
+ * @param urls URLs dos servidores Ollama usados em rodízio (NULL para o servidor padrão)
+ * @param num_urls Número de URLs
+ * @param max_in_flight Limite de requisições simultâneas (no mínimo uma por servidor)
+ * @param batch_size Músicas por requisição (1 = uma música por prompt); músicas que faltarem
+ *                   na resposta de um lote são reenviadas e, após OLLAMA_BATCH_MAX_RETRIES
+ *                   tentativas, classificadas sozinhas (assim como as de um lote cujo prompt
+ *                   não pôde ser montado)
+ * @param labels Saída: classificação de cada música (0, 1, 2), ou -1 se a requisição falhou
+ * @param batched Saída opcional (NULL = ignorada): 1 se a música foi respondida com o prompt
+ *                de lote (OLLAMA_BATCH_PRE_PROMPT), 0 se com o prompt simples (OLLAMA_PRE_PROMPT)
+ * @return Número de músicas classificadas com sucesso
+ */
+int classify_lyrics_concurrent(char **lyrics, int count, const char *const *urls, int num_urls, int max_in_flight, int batch_size, int *labels, int *batched);
+
 #endif // OLLAMA_CLIENT_H
\ No newline at end of file
@@ -0,0 +1,74 @@
+# Servidor falso da API do Ollama para os benchmarks: responde /api/generate com uma
+# classificação determinística (hash do prompt) após um atraso fixo, sem modelo nem GPU.
+# Entende os dois formatos usados pelo main: uma letra por prompt (resposta "0", "1"
+# ou "2") e lotes com campo "format" (resposta {"results": [{"id", "label"}]}).
+import argparse
+import json
+import re
+import time
+import zlib
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+SONG_HEADER = re.compile(r"^### Song (\d+)$", re.MULTILINE)  # OLLAMA_BATCH_SONG_HEADER
+
+
+def label_for(text: str) -> int:
+    return zlib.crc32(text.encode("utf-8")) % 3
+
+
+class StubHandler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"  # Responde ao "Expect: 100-continue" do libcurl e mantém a conexão
+    disable_nagle_algorithm = True  # Cabeçalho e corpo saem em escritas separadas: evita os 40 ms do ACK atrasado
+    delay = 0.0
+
+    def do_POST(self):
+        length = int(self.headers.get("Content-Length", 0))
+        try:
+            request = json.loads(self.rfile.read(length))
+        except ValueError:
+            self.send_error(400)
+            return
+        if self.path != "/api/generate":
+            self.send_error(404)
+            return
+
+        prompt = request.get("prompt", "")
+        if "format" in request:
+            # Lote: divide o prompt nos cabeçalhos "### Song N" e classifica cada letra
+            parts = SONG_HEADER.split(prompt)
+            results = [{"id": int(parts[i]), "label": label_for(parts[i + 1])}
+                       for i in range(1, len(parts) - 1, 2)]
+            text = json.dumps({"results": results})
+        else:
+            text = str(label_for(prompt))
+
+        time.sleep(self.delay)
+        body = json.dumps({"model": request.get("model", ""), "response": text, "done": True}).encode("utf-8")
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def log_message(self, format, *args):
+        pass  # Sem uma linha de log por requisição
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Servidor falso do Ollama para benchmarks")
+    parser.add_argument("--port", type=int, default=11435)
+    parser.add_argument("--delay-ms", type=float, default=20.0, help="atraso de cada resposta (simula o modelo)")
+    args = parser.parse_args()
+
+    StubHandler.delay = args.delay_ms / 1000.0
+    ThreadingHTTPServer.request_queue_size = 1024  # Várias conexões simultâneas por processo MPI (o padrão é 5)
+    server = ThreadingHTTPServer(("127.0.0.1", args.port), StubHandler)
+    server.daemon_threads = True
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,72 @@
+#include "phase_timer.h"
+#include <stdio.h>    // Para gravar o JSON
+
+// Inicia o cronômetro
+void phase_timer_start(PhaseTimer *timer) {
+    timer->count = 0;
+    timer->start = MPI_Wtime();
+    timer->last_mark = timer->start;
+}
+
+// Fecha a fase atual e inicia a próxima
+void phase_timer_mark(PhaseTimer *timer, const char *name) {
+    double now = MPI_Wtime();
+    if (timer->count < PHASE_TIMER_MAX_PHASES) {
+        timer->phases[timer->count].name = name;
+        timer->phases[timer->count].seconds = now - timer->last_mark;
+        timer->count++;
+    }
+    timer->last_mark = now;
+}
+
+// Escreve uma string JSON, escapando aspas, barras e caracteres de controle
+static void write_json_string(FILE *file, const char *text) {
+    fputc('"', file);
+    for (const unsigned char *p = (const unsigned char *)text; *p; p++) {
+        if (*p == '"' || *p == '\\') fprintf(file, "\\%c", *p);
+        else if (*p < 0x20) fprintf(file, "\\u%04x", *p);
+        else fputc(*p, file);
+    }
+    fputc('"', file);
+}
+
+// Combina os tempos entre os processos e grava o JSON no root
+int phase_timer_write_json(const PhaseTimer *timer, const char *path, int argc, char *argv[],
+                           long total_songs, int root, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    // Última posição guarda o tempo total
+    int n = timer->count;
+    double local[PHASE_TIMER_MAX_PHASES + 1], min[PHASE_TIMER_MAX_PHASES + 1];
+    double max[PHASE_TIMER_MAX_PHASES + 1], sum[PHASE_TIMER_MAX_PHASES + 1];
+    for (int i = 0; i < n; i++) {
+        local[i] = timer->phases[i].seconds;
+    }
+    local[n] = timer->last_mark - timer->start;
+    MPI_Reduce(local, min, n + 1, MPI_DOUBLE, MPI_MIN, root, comm);
+    MPI_Reduce(local, max, n + 1, MPI_DOUBLE, MPI_MAX, root, comm);
+    MPI_Reduce(local, sum, n + 1, MPI_DOUBLE, MPI_SUM, root, comm);
+    if (rank != root) return 0;
+
+    FILE *file = fopen(path, "w");
+    if (!file) return -1;
+
+    fprintf(file, "{\n  \"ranks\": %d,\n  \"songs\": %ld,\n  \"args\": [", size, total_songs);
+    for (int i = 1; i < argc; i++) {
+        if (i > 1) fprintf(file, ", ");
+        write_json_string(file, argv[i]);
+    }
+    fprintf(file, "],\n  \"phases\": [\n");
+    for (int i = 0; i < n; i++) {
+        fprintf(file, "    {\"name\": ");
+        write_json_string(file, timer->phases[i].name);
+        fprintf(file, ", \"min\": %.6f, \"mean\": %.6f, \"max\": %.6f}%s\n",
+                min[i], sum[i] / size, max[i], (i + 1 < n) ? "," : "");
+    }
+    // O processo mais lento define o tempo total e a vazão
+    fprintf(file, "  ],\n  \"total_seconds\": %.6f,\n  \"songs_per_second\": %.1f\n}\n",
+            max[n], max[n] > 0.0 ? total_songs / max[n] : 0.0);
+    return fclose(file) == 0 ? 0 : -1;
+}
@@ -0,0 +1,56 @@
+#ifndef PHASE_TIMER_H
+#define PHASE_TIMER_H
+
+// Inclusão das bibliotecas necessárias
+#include <mpi.h>      // Para MPI_Wtime e a combinação dos tempos entre processos
+
+#define PHASE_TIMER_MAX_PHASES 16  // Máximo de fases medidas por execução
+
+// Tempo de uma fase neste processo
+typedef struct {
+    const char *name;   // Nome da fase (literal; vira a chave no JSON)
+    double seconds;     // Duração medida com MPI_Wtime
+} PhaseTime;
+
+// Cronômetro das fases do programa: cada marca fecha a fase atual e abre a próxima.
+// As medições ficam dentro do programa, sem contar a inicialização do mpirun nem a
+// impressão dos resultados.
+typedef struct {
+    PhaseTime phases[PHASE_TIMER_MAX_PHASES];
+    int count;          // Fases fechadas
+    double start;       // Início da execução medida
+    double last_mark;   // Início da fase atual
+} PhaseTimer;
+
+// Declarações das funções
+
+/**
+ * Inicia o cronômetro (primeira fase começa agora)
+ * @param timer Cronômetro a iniciar
+ */
+void phase_timer_start(PhaseTimer *timer);
+
+/**
+ * Fecha a fase atual com o nome dado e inicia a próxima
+ * @param timer Cronômetro
+ * @param name Nome da fase que termina agora (string literal)
+ */
+void phase_timer_mark(PhaseTimer *timer, const char *name);
+
+/**
+ * Combina os tempos de todos os processos (mínimo, média e máximo de cada fase) e o
+ * processo root grava um objeto JSON com eles. Operação coletiva: todos os processos
+ * precisam ter marcado as mesmas fases na mesma ordem
+ * @param timer Cronômetro deste processo
+ * @param path Arquivo JSON a gravar (usado apenas no root)
+ * @param argc Número de argumentos do programa (registrados como configuração)
+ * @param argv Argumentos do programa
+ * @param total_songs Músicas analisadas (para a vazão)
+ * @param root Processo que grava o arquivo
+ * @param comm Comunicador MPI
+ * @return 0 em caso de sucesso, -1 se o arquivo não pôde ser gravado
+ */
+int phase_timer_write_json(const PhaseTimer *timer, const char *path, int argc, char *argv[],
+                           long total_songs, int root, MPI_Comm comm);
+
+#endif // PHASE_TIMER_H
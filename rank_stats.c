@@ -0,0 +1,148 @@
+#include "rank_stats.h"
+#include <stdio.h>    // Para o resumo e o JSON
+#include <stdlib.h>   // Para funções de alocação de memória
+
+static const char *activity_names[STAT_NUM_ACTIVITIES] = {
+    "io", "tokenize", "merge", "comm", "llm", "other"
+};
+static const char *counter_names[STAT_NUM_COUNTERS] = {
+    "bytes_read", "records", "chunks", "tokens", "word_keys", "artist_keys", "bytes_sent", "llm_songs"
+};
+
+// Estado deste processo: poucas variáveis, atualizadas apenas pela thread principal
+static double seconds[STAT_NUM_ACTIVITIES];
+static long long counters[STAT_NUM_COUNTERS];
+static StatActivity current = STAT_OTHER;
+static double current_since;
+
+void rank_stats_start(void) {
+    for (int i = 0; i < STAT_NUM_ACTIVITIES; i++) seconds[i] = 0.0;
+    for (int i = 0; i < STAT_NUM_COUNTERS; i++) counters[i] = 0;
+    current = STAT_OTHER;
+    current_since = MPI_Wtime();
+}
+
+StatActivity rank_stats_enter(StatActivity activity) {
+    StatActivity previous = current;
+    if (activity != current) {
+        double now = MPI_Wtime();
+        seconds[current] += now - current_since;
+        current = activity;
+        current_since = now;
+    }
+    return previous;
+}
+
+void rank_stats_add(StatCounter counter, long long amount) {
+    counters[counter] += amount;
+}
+
+// Resumo impresso pelo root
+static void print_summary(const double *all_seconds, const long long *all_counters, int size) {
+    // Processo mais lento: define o fim da execução (caminho crítico)
+    int slowest = 0;
+    double slowest_total = -1.0;
+    double mean_total = 0.0;
+    for (int r = 0; r < size; r++) {
+        double total = 0.0;
+        for (int a = 0; a < STAT_NUM_ACTIVITIES; a++) total += all_seconds[r * STAT_NUM_ACTIVITIES + a];
+        mean_total += total / size;
+        if (total > slowest_total) {
+            slowest_total = total;
+            slowest = r;
+        }
+    }
+
+    printf("\n========================================\n");
+    printf("INSTRUMENTAÇÃO POR PROCESSO (%d processos)\n", size);
+    printf("========================================\n");
+    // Larguras +1 por letra acentuada: printf conta bytes, não caracteres
+    printf("%-12s %11s %11s %11s %10s %7s %10s\n", "atividade", "mín (s)", "média (s)", "máx (s)", "máx/méd", "proc", "lento (s)");
+    for (int a = 0; a < STAT_NUM_ACTIVITIES; a++) {
+        double min = 0.0, max = 0.0, sum = 0.0;
+        int argmax = 0;
+        for (int r = 0; r < size; r++) {
+            double v = all_seconds[r * STAT_NUM_ACTIVITIES + a];
+            if (r == 0 || v < min) min = v;
+            if (r == 0 || v > max) { max = v; argmax = r; }
+            sum += v;
+        }
+        double mean = sum / size;
+        printf("%-12s %10.4f %10.4f %10.4f %8.2f %7d %10.4f\n", activity_names[a], min, mean, max,
+               mean > 0.0 ? max / mean : 1.0, argmax, all_seconds[slowest * STAT_NUM_ACTIVITIES + a]);
+    }
+    printf("%-12s %10s %10.4f %10.4f %8.2f %7d\n", "total", "", mean_total, slowest_total,
+           mean_total > 0.0 ? slowest_total / mean_total : 1.0, slowest);
+
+    printf("\n%-12s %15s %15s %15s %10s\n", "contador", "mín", "média", "máx", "máx/méd");
+    for (int c = 0; c < STAT_NUM_COUNTERS; c++) {
+        long long min = 0, max = 0, sum = 0;
+        for (int r = 0; r < size; r++) {
+            long long v = all_counters[r * STAT_NUM_COUNTERS + c];
+            if (r == 0 || v < min) min = v;
+            if (r == 0 || v > max) max = v;
+            sum += v;
+        }
+        double mean = (double)sum / size;
+        printf("%-12s %14lld %14.0f %14lld %8.2f\n", counter_names[c], min, mean, max, mean > 0.0 ? max / mean : 1.0);
+    }
+
+    // Onde o processo mais lento gastou o tempo
+    printf("\nCaminho crítico: processo %d (%.4f s, %.1f%% acima da média)\n", slowest, slowest_total,
+           mean_total > 0.0 ? (slowest_total / mean_total - 1.0) * 100.0 : 0.0);
+    for (int a = 0; a < STAT_NUM_ACTIVITIES; a++) {
+        double v = all_seconds[slowest * STAT_NUM_ACTIVITIES + a];
+        printf("  %-10s %8.4f s (%5.1f%%)\n", activity_names[a], v, slowest_total > 0.0 ? v / slowest_total * 100.0 : 0.0);
+    }
+}
+
+// Valores de cada processo em JSON
+static int write_json(const char *path, const double *all_seconds, const long long *all_counters, int size) {
+    FILE *file = fopen(path, "w");
+    if (!file) return -1;
+    fprintf(file, "{\n  \"ranks\": %d,\n  \"seconds\": {\n", size);
+    for (int a = 0; a < STAT_NUM_ACTIVITIES; a++) {
+        fprintf(file, "    \"%s\": [", activity_names[a]);
+        for (int r = 0; r < size; r++) {
+            fprintf(file, "%s%.6f", r > 0 ? ", " : "", all_seconds[r * STAT_NUM_ACTIVITIES + a]);
+        }
+        fprintf(file, "]%s\n", (a + 1 < STAT_NUM_ACTIVITIES) ? "," : "");
+    }
+    fprintf(file, "  },\n  \"counters\": {\n");
+    for (int c = 0; c < STAT_NUM_COUNTERS; c++) {
+        fprintf(file, "    \"%s\": [", counter_names[c]);
+        for (int r = 0; r < size; r++) {
+            fprintf(file, "%s%lld", r > 0 ? ", " : "", all_counters[r * STAT_NUM_COUNTERS + c]);
+        }
+        fprintf(file, "]%s\n", (c + 1 < STAT_NUM_COUNTERS) ? "," : "");
+    }
+    fprintf(file, "  }\n}\n");
+    return fclose(file) == 0 ? 0 : -1;
+}
+
+int rank_stats_report(const char *json_path, int print, int root, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    double now = MPI_Wtime();
+    seconds[current] += now - current_since;  // Fecha o trecho em andamento sem trocar de atividade
+    current_since = now;
+
+    double *all_seconds = NULL;
+    long long *all_counters = NULL;
+    if (rank == root) {
+        all_seconds = malloc((size_t)size * STAT_NUM_ACTIVITIES * sizeof(double));
+        all_counters = malloc((size_t)size * STAT_NUM_COUNTERS * sizeof(long long));
+    }
+    MPI_Gather(seconds, STAT_NUM_ACTIVITIES, MPI_DOUBLE, all_seconds, STAT_NUM_ACTIVITIES, MPI_DOUBLE, root, comm);
+    MPI_Gather(counters, STAT_NUM_COUNTERS, MPI_LONG_LONG, all_counters, STAT_NUM_COUNTERS, MPI_LONG_LONG, root, comm);
+
+    int result = 0;
+    if (rank == root) {
+        if (print) print_summary(all_seconds, all_counters, size);
+        if (json_path) result = write_json(json_path, all_seconds, all_counters, size);
+        free(all_seconds);
+        free(all_counters);
+    }
+    return result;
+}
@@ -0,0 +1,68 @@
+#ifndef RANK_STATS_H
+#define RANK_STATS_H
+
+// Inclusão das bibliotecas necessárias
+#include <mpi.h>      // Para MPI_Wtime e a coleta no processo 0
+
+// Atividades em que o tempo de cada processo é dividido. O tempo é atribuído de
+// forma exclusiva: entrar numa atividade encerra a anterior, então a soma das
+// atividades é o tempo total do processo.
+typedef enum {
+    STAT_IO = 0,      // Leitura e separação dos campos dos pedaços
+    STAT_TOKENIZE,    // Análise das músicas (separação das palavras e contagem)
+    STAT_MERGE,       // Soma de tabelas (estados das threads, tabelas recebidas)
+    STAT_COMM,        // Comunicação MPI (reduções, distribuição dos pedaços e das músicas do LLM)
+    STAT_LLM,         // Consulta ao cache de sentimentos e requisições ao Ollama
+    STAT_OTHER,       // Todo o resto (inicialização, impressão)
+    STAT_NUM_ACTIVITIES
+} StatActivity;
+
+// Contadores de trabalho de cada processo
+typedef enum {
+    STAT_BYTES_READ = 0,  // Bytes das músicas lidas (artista + música + letra)
+    STAT_RECORDS,         // Músicas entregues aos analisadores
+    STAT_CHUNKS,          // Pedaços processados
+    STAT_TOKENS,          // Palavras contadas
+    STAT_WORD_KEYS,       // Palavras distintas na tabela local
+    STAT_ARTIST_KEYS,     // Artistas distintos na tabela local
+    STAT_BYTES_SENT,      // Bytes de contagens enviados na redução
+    STAT_LLM_SONGS,       // Músicas classificadas por este processo (cache + LLM)
+    STAT_NUM_COUNTERS
+} StatCounter;
+
+// Declarações das funções
+// Só a thread principal de cada processo registra tempos e contadores.
+
+/**
+ * Zera os contadores e começa a contar o tempo em STAT_OTHER
+ */
+void rank_stats_start(void);
+
+/**
+ * Encerra a atividade atual e passa a contar o tempo na atividade dada
+ * @param activity Nova atividade
+ * @return Atividade anterior (para restaurar ao sair de um trecho aninhado)
+ */
+StatActivity rank_stats_enter(StatActivity activity);
+
+/**
+ * Soma um valor a um contador deste processo
+ * @param counter Contador
+ * @param amount Valor a somar
+ */
+void rank_stats_add(StatCounter counter, long long amount);
+
+/**
+ * Reúne os tempos e contadores de todos os processos no root, que imprime o resumo:
+ * mínimo, média e máximo de cada atividade e contador, desequilíbrio (máximo / média),
+ * processo mais lento e a divisão do seu tempo (caminho crítico). Opcionalmente grava
+ * os valores de cada processo em JSON. Operação coletiva
+ * @param json_path Arquivo JSON a gravar (NULL = apenas imprime)
+ * @param print Imprime o resumo (0 = apenas grava o JSON)
+ * @param root Processo que recebe os dados
+ * @param comm Comunicador MPI
+ * @return 0 em caso de sucesso, -1 se o JSON não pôde ser gravado
+ */
+int rank_stats_report(const char *json_path, int print, int root, MPI_Comm comm);
+
+#endif // RANK_STATS_H
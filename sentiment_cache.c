@@ -0,0 +1,201 @@
+#include "sentiment_cache.h"
+#include <stdio.h>     // Para fprintf
+#include <stdlib.h>    // Para funções de alocação de memória
+#include <string.h>    // Para memcpy
+#include <fcntl.h>     // Para open com O_APPEND
+#include <unistd.h>    // Para read, write, ftruncate e close
+#include <sys/file.h>  // Para flock
+#include <sys/stat.h>  // Para fstat
+
+#define SENTIMENT_RECORD_SIZE 17  // Chave (16 bytes) + classificação (1 byte)
+
+// Mistura final de 64 bits (murmur3)
+static uint64_t fmix64(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// Alimenta as duas metades do hash com uma parte da chave
+static void hash_part(uint64_t *a, uint64_t *b, const char *data) {
+    for (const unsigned char *p = (const unsigned char *)data; *p; p++) {
+        *a = (*a ^ *p) * 1099511628211ULL;                  // FNV-1a
+        *b = (*b ^ *p) * 0x9e3779b97f4a7c15ULL;
+        *b = (*b << 31) | (*b >> 33);
+    }
+    // Separador que não aparece em texto UTF-8: "ab"+"c" difere de "a"+"bc"
+    *a = (*a ^ 0xff) * 1099511628211ULL;
+    *b = (*b ^ 0xff) * 0x9e3779b97f4a7c15ULL;
+}
+
+// Calcula a chave do cache para uma classificação
+SentimentKey sentiment_cache_key(const char *model, const char *prompt, const char *lyrics) {
+    uint64_t a = 1469598103934665603ULL;
+    uint64_t b = 0x243f6a8885a308d3ULL;
+    hash_part(&a, &b, model);
+    hash_part(&a, &b, prompt);
+    hash_part(&a, &b, lyrics);
+
+    SentimentKey key;
+    key.hi = fmix64(a ^ ((b << 17) | (b >> 47)));
+    key.lo = fmix64(b + a);
+    if (key.hi == 0 && key.lo == 0) key.lo = 1;  // {0,0} é reservado para posições vazias
+    return key;
+}
+
+// Posição inicial de uma chave na tabela
+static size_t key_slot(const SentimentCache *cache, SentimentKey key) {
+    return (size_t)key.lo & (cache->capacity - 1);
+}
+
+// Insere ou atualiza uma chave na tabela em memória, dobrando-a acima de 75% de ocupação
+static void cache_put(SentimentCache *cache, SentimentKey key, int label) {
+    if ((cache->size + 1) * 4 > cache->capacity * 3) {
+        SentimentKey *old_keys = cache->keys;
+        unsigned char *old_labels = cache->labels;
+        size_t old_capacity = cache->capacity;
+
+        cache->capacity *= 2;
+        cache->keys = calloc(cache->capacity, sizeof(SentimentKey));
+        cache->labels = malloc(cache->capacity);
+        cache->size = 0;
+        for (size_t i = 0; i < old_capacity; i++) {
+            if (old_keys[i].hi != 0 || old_keys[i].lo != 0) cache_put(cache, old_keys[i], old_labels[i]);
+        }
+        free(old_keys);
+        free(old_labels);
+    }
+
+    size_t mask = cache->capacity - 1;
+    size_t pos = key_slot(cache, key);
+    while (cache->keys[pos].hi != 0 || cache->keys[pos].lo != 0) {
+        if (cache->keys[pos].hi == key.hi && cache->keys[pos].lo == key.lo) {
+            cache->labels[pos] = (unsigned char)label;
+            return;
+        }
+        pos = (pos + 1) & mask;
+    }
+    cache->keys[pos] = key;
+    cache->labels[pos] = (unsigned char)label;
+    cache->size++;
+}
+
+// Abre o cache e carrega os registros existentes
+SentimentCache* sentiment_cache_open(const char *path) {
+    SentimentCache *cache = malloc(sizeof(SentimentCache));
+    cache->path = strdup(path);
+    cache->capacity = 1024;
+    cache->keys = calloc(cache->capacity, sizeof(SentimentKey));
+    cache->labels = malloc(cache->capacity);
+    cache->size = 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return cache;  // Cache ainda não existe: começa vazio
+
+    // Trava compartilhada: não lê no meio de um acréscimo de outro processo
+    if (flock(fd, LOCK_SH) != 0) {
+        fprintf(stderr, "Aviso: não foi possível travar o cache de sentimentos em %s; começando vazio\n", path);
+        close(fd);
+        return cache;
+    }
+    struct stat st;
+    char *data = NULL;
+    size_t size = 0;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        data = malloc(st.st_size);
+        ssize_t n;
+        while (size < (size_t)st.st_size && (n = read(fd, data + size, st.st_size - size)) > 0) {
+            size += n;
+        }
+    }
+    flock(fd, LOCK_UN);
+    close(fd);
+
+    // Registro final incompleto (gravação interrompida) é ignorado
+    for (size_t offset = 0; offset + SENTIMENT_RECORD_SIZE <= size; offset += SENTIMENT_RECORD_SIZE) {
+        SentimentKey key;
+        memcpy(&key.hi, data + offset, sizeof(uint64_t));
+        memcpy(&key.lo, data + offset + sizeof(uint64_t), sizeof(uint64_t));
+        unsigned char label = (unsigned char)data[offset + 2 * sizeof(uint64_t)];
+        if ((key.hi != 0 || key.lo != 0) && label <= 2) cache_put(cache, key, label);
+    }
+    free(data);
+    return cache;
+}
+
+// Consulta a classificação de uma chave
+int sentiment_cache_lookup(const SentimentCache *cache, SentimentKey key) {
+    size_t mask = cache->capacity - 1;
+    size_t pos = key_slot(cache, key);
+    while (cache->keys[pos].hi != 0 || cache->keys[pos].lo != 0) {
+        if (cache->keys[pos].hi == key.hi && cache->keys[pos].lo == key.lo) {
+            return cache->labels[pos];
+        }
+        pos = (pos + 1) & mask;
+    }
+    return -1;
+}
+
+// Acrescenta novas classificações ao cache em memória e ao arquivo
+int sentiment_cache_append(SentimentCache *cache, const SentimentKey *keys, const int *labels, int count) {
+    // Monta todos os registros num único buffer: uma só chamada a write
+    char *records = malloc(count > 0 ? (size_t)count * SENTIMENT_RECORD_SIZE : 1);
+    size_t size = 0;
+    for (int i = 0; i < count; i++) {
+        if (labels[i] < 0 || labels[i] > 2) continue;
+        cache_put(cache, keys[i], labels[i]);
+        memcpy(records + size, &keys[i].hi, sizeof(uint64_t));
+        memcpy(records + size + sizeof(uint64_t), &keys[i].lo, sizeof(uint64_t));
+        records[size + 2 * sizeof(uint64_t)] = (char)labels[i];
+        size += SENTIMENT_RECORD_SIZE;
+    }
+    if (size == 0) {
+        free(records);
+        return 0;
+    }
+
+    int fd = open(cache->path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Aviso: não foi possível gravar o cache de sentimentos em %s\n", cache->path);
+        free(records);
+        return -1;
+    }
+
+    // Trava exclusiva: acréscimos de processos diferentes não se intercalam
+    if (flock(fd, LOCK_EX) != 0) {
+        fprintf(stderr, "Aviso: não foi possível travar o cache de sentimentos em %s\n", cache->path);
+        close(fd);
+        free(records);
+        return -1;
+    }
+
+    // Registro final incompleto (gravação interrompida) é descartado antes do acréscimo;
+    // senão todos os registros seguintes seriam lidos deslocados
+    struct stat st;
+    size_t written = 0;
+    if (fstat(fd, &st) == 0 &&
+        (st.st_size % SENTIMENT_RECORD_SIZE == 0 ||
+         ftruncate(fd, st.st_size - st.st_size % SENTIMENT_RECORD_SIZE) == 0)) {
+        ssize_t n;
+        while (written < size && (n = write(fd, records + written, size - written)) > 0) {
+            written += n;
+        }
+    }
+    flock(fd, LOCK_UN);
+    close(fd);
+    free(records);
+    return written == size ? 0 : -1;
+}
+
+// Libera a memória do cache
+void sentiment_cache_close(SentimentCache *cache) {
+    if (cache) {
+        free(cache->path);
+        free(cache->keys);
+        free(cache->labels);
+        free(cache);
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef SENTIMENT_CACHE_H
+#define SENTIMENT_CACHE_H
+
+// Inclusão das bibliotecas necessárias
+#include <stddef.h>   // Para size_t
+#include <stdint.h>   // Para inteiros de tamanho fixo
+
+// Arquivo padrão do cache de classificações (--llm-cache)
+#define SENTIMENT_CACHE_DEFAULT_PATH "sentiment_cache.bin"
+
+// Chave de 128 bits: hash de modelo + prompt + letra
+typedef struct {
+    uint64_t hi;  // Metade alta do hash
+    uint64_t lo;  // Metade baixa do hash (nunca é 0 junto com hi)
+} SentimentKey;
+
+// Cache de classificações em memória, espelhando um arquivo só de acréscimo.
+// Cada registro no arquivo ocupa 17 bytes: chave (16) + classificação (1).
+typedef struct {
+    char *path;             // Arquivo do cache
+    SentimentKey *keys;     // Tabela de endereçamento aberto ({0,0} = vazio)
+    unsigned char *labels;  // Classificação de cada chave
+    size_t capacity;        // Número de posições (potência de 2)
+    size_t size;            // Número de chaves armazenadas
+} SentimentCache;
+
+// Declarações das funções
+
+/**
+ * Calcula a chave do cache para uma classificação
+ * @param model Nome do modelo
+ * @param prompt Prompt fixo enviado antes da letra
+ * @param lyrics Letra da música
+ * @return Chave de 128 bits
+ */
+SentimentKey sentiment_cache_key(const char *model, const char *prompt, const char *lyrics);
+
+/**
+ * Abre o cache e carrega os registros existentes (registro final incompleto é ignorado)
+ * @param path Caminho do arquivo (criado na primeira gravação)
+ * @return Ponteiro para SentimentCache alocado
+ */
+SentimentCache* sentiment_cache_open(const char *path);
+
+/**
+ * Consulta a classificação de uma chave
+ * @param cache Cache aberto
+ * @param key Chave da classificação
+ * @return 0, 1 ou 2 se a chave estiver no cache, -1 caso contrário
+ */
+int sentiment_cache_lookup(const SentimentCache *cache, SentimentKey key);
+
+/**
+ * Acrescenta novas classificações ao cache em memória e ao arquivo. A gravação
+ * usa O_APPEND e trava o arquivo (flock) durante uma única chamada a write, de
+ * modo que vários processos podem acrescentar registros ao mesmo arquivo
+ * @param cache Cache aberto
+ * @param keys Chaves das classificações
+ * @param labels Classificações (0, 1 ou 2; valores negativos são ignorados)
+ * @param count Número de classificações
+ * @return 0 em caso de sucesso, -1 se o arquivo não pôde ser gravado
+ */
+int sentiment_cache_append(SentimentCache *cache, const SentimentKey *keys, const int *labels, int count);
+
+/**
+ * Libera a memória do cache
+ * @param cache Ponteiro para SentimentCache a ser liberado
+ */
+void sentiment_cache_close(SentimentCache *cache);
+
+#endif // SENTIMENT_CACHE_H
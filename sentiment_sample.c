@@ -0,0 +1,70 @@
+#include "sentiment_sample.h"
+#include <stdlib.h>   // Para funções de alocação de memória
+#include <stdint.h>   // Para inteiros de tamanho fixo
+#include <math.h>     // Para sqrt
+
+#define SAMPLE_Z 1.959964   // Quantil da normal para 95% de confiança
+
+// Mistura splitmix64: posição pseudoaleatória e reproduzível dentro de cada estrato
+static uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Inverte os 'bits' bits menos significativos de value
+static uint32_t reverse_bits(uint32_t value, int bits) {
+    uint32_t result = 0;
+    for (int i = 0; i < bits; i++) {
+        result = (result << 1) | ((value >> i) & 1);
+    }
+    return result;
+}
+
+// Monta o plano da amostra estratificada
+SamplePlan* sample_plan_create(int first_song, int end_song, int max_songs) {
+    SamplePlan *plan = malloc(sizeof(SamplePlan));
+    plan->population = end_song > first_song ? end_song - first_song : 0;
+    plan->count = max_songs < plan->population ? max_songs : plan->population;
+    plan->songs = malloc((plan->count > 0 ? plan->count : 1) * sizeof(int));
+
+    // Estratos visitados em ordem de bits invertidos (0, 1/2, 1/4, 3/4, ...)
+    int bits = 0;
+    while ((1LL << bits) < plan->count) bits++;
+    int filled = 0;
+    for (uint32_t i = 0; filled < plan->count; i++) {
+        uint32_t stratum = reverse_bits(i, bits);
+        if ((int)stratum >= plan->count) continue;
+        long long begin = (long long)plan->population * stratum / plan->count;
+        long long end = (long long)plan->population * (stratum + 1) / plan->count;
+        long long offset = (long long)(mix(SAMPLE_SEED ^ stratum) % (uint64_t)(end - begin));
+        plan->songs[filled++] = first_song + (int)(begin + offset);
+    }
+    return plan;
+}
+
+// Libera a memória do plano
+void sample_plan_free(SamplePlan *plan) {
+    if (plan) {
+        free(plan->songs);
+        free(plan);
+    }
+}
+
+// Pior largura do intervalo de Wilson de 95% entre as três proporções
+double sample_ci_width(const int *counts, int population) {
+    int n = counts[0] + counts[1] + counts[2];
+    if (n == 0) return 1.0;
+
+    // Correção de população finita: a amostra inteira tem largura 0
+    double fpc = (population > 1 && n < population) ? sqrt((double)(population - n) / (population - 1)) : 0.0;
+    double z2 = SAMPLE_Z * SAMPLE_Z;
+    double worst = 0.0;
+    for (int i = 0; i < 3; i++) {
+        double p = (double)counts[i] / n;
+        double half = SAMPLE_Z * sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n)) / (1.0 + z2 / n);
+        if (2.0 * half * fpc > worst) worst = 2.0 * half * fpc;
+    }
+    return worst;
+}
@@ -0,0 +1,45 @@
+#ifndef SENTIMENT_SAMPLE_H
+#define SENTIMENT_SAMPLE_H
+
+#define SAMPLE_DEFAULT_CI_WIDTH 0.10   // Largura alvo padrão do intervalo de confiança de 95%
+#define SAMPLE_MIN_SONGS 30            // Músicas classificadas antes de considerar a parada
+#define SAMPLE_SEED 0x5eed5a3b1e5ULL   // Semente da posição sorteada dentro de cada estrato
+
+// Plano da amostra estratificada: o trecho do arquivo é dividido em estratos do mesmo
+// tamanho (o CSV é ordenado por artista, então estratos por posição espalham a amostra
+// entre os artistas) e uma música é sorteada em cada estrato. A ordem de classificação
+// percorre os estratos em ordem de bits invertidos, então qualquer prefixo da ordem
+// também cobre o arquivo inteiro de forma uniforme e a parada antecipada não enviesa
+typedef struct {
+    int *songs;        // Índice global da música de cada posição da ordem de classificação
+    int count;         // Número de estratos (músicas da amostra completa)
+    int population;    // Músicas do trecho amostrado
+} SamplePlan;
+
+// Declarações das funções
+
+/**
+ * Monta o plano da amostra estratificada
+ * @param first_song Primeira música do trecho amostrado
+ * @param end_song Fim (exclusivo) do trecho amostrado
+ * @param max_songs Número máximo de músicas da amostra (estratos)
+ * @return Ponteiro para SamplePlan alocado
+ */
+SamplePlan* sample_plan_create(int first_song, int end_song, int max_songs);
+
+/**
+ * Libera a memória do plano
+ * @param plan Ponteiro para SamplePlan a ser liberado
+ */
+void sample_plan_free(SamplePlan *plan);
+
+/**
+ * Maior largura, entre positivo/neutro/negativo, do intervalo de confiança de 95% da
+ * proporção (intervalo de Wilson com correção de população finita)
+ * @param counts Classificações acumuladas [Positivo, Neutro, Negativo]
+ * @param population Tamanho da população amostrada
+ * @return Largura do pior intervalo (1.0 se ainda não há classificações)
+ */
+double sample_ci_width(const int *counts, int population);
+
+#endif // SENTIMENT_SAMPLE_H
@@ -0,0 +1,286 @@
+#include "sketch.h"
+#include <stdlib.h>          // Para funções de alocação de memória
+#include <string.h>          // Para memcpy e memcmp
+#include <limits.h>          // Para INT_MAX
+#include <math.h>            // Para log, sqrt e exp
+#include "count_exchange.h"  // Para reunir as chaves candidatas no root
+#include "rank_stats.h"      // Para contar os bytes enviados na redução
+
+#define SKETCH_REGISTERS (1 << SKETCH_HLL_PRECISION)
+#define SKETCH_INDEX_SIZE (4 * SKETCH_CANDIDATES)  // Potência de 2, ocupação máxima de 25%
+#define INDEX_EMPTY -1
+#define INDEX_REMOVED -2
+
+// Cria um sketch vazio
+Sketch* sketch_create(void) {
+    Sketch *sketch = malloc(sizeof(Sketch));
+    sketch->counts = calloc((size_t)SKETCH_DEPTH * SKETCH_WIDTH, sizeof(uint64_t));
+    sketch->total = 0;
+    sketch->registers = calloc(SKETCH_REGISTERS, sizeof(uint8_t));
+    sketch->candidates = malloc(SKETCH_CANDIDATES * sizeof(SketchCandidate));
+    sketch->num_candidates = 0;
+    sketch->index = malloc(SKETCH_INDEX_SIZE * sizeof(int));
+    for (int i = 0; i < SKETCH_INDEX_SIZE; i++) sketch->index[i] = INDEX_EMPTY;
+    sketch->tombstones = 0;
+    return sketch;
+}
+
+// Libera a memória do sketch
+void sketch_free(Sketch *sketch) {
+    if (sketch) {
+        free(sketch->counts);
+        free(sketch->registers);
+        free(sketch->candidates);
+        free(sketch->index);
+        free(sketch);
+    }
+}
+
+// Coluna da linha 'row' para o hash (hashing duplo: h1 + row * h2)
+static inline size_t column(uint64_t hash, int row) {
+    uint32_t h1 = (uint32_t)hash;
+    uint32_t h2 = (uint32_t)(hash >> 32) | 1;
+    return (size_t)row * SKETCH_WIDTH + ((h1 + (uint32_t)row * h2) & (SKETCH_WIDTH - 1));
+}
+
+// Estimativa do Count-Min: o menor contador da chave
+static uint64_t estimate(const Sketch *sketch, uint64_t hash) {
+    uint64_t min = sketch->counts[column(hash, 0)];
+    for (int row = 1; row < SKETCH_DEPTH; row++) {
+        uint64_t value = sketch->counts[column(hash, row)];
+        if (value < min) min = value;
+    }
+    return min;
+}
+
+// Registra o hash no HyperLogLog: balde pelos bits altos, zeros iniciais do resto
+static inline void hll_add(uint8_t *registers, uint64_t hash) {
+    // Remistura: o Count-Min já usa os bits do hash original
+    hash ^= hash >> 31;
+    hash *= 0x9e3779b97f4a7c15ULL;
+    hash ^= hash >> 29;
+    size_t bucket = hash >> (64 - SKETCH_HLL_PRECISION);
+    uint64_t rest = hash << SKETCH_HLL_PRECISION;
+    uint8_t rank = rest ? (uint8_t)(__builtin_clzll(rest) + 1) : (uint8_t)(64 - SKETCH_HLL_PRECISION + 1);
+    if (rank > registers[bucket]) registers[bucket] = rank;
+}
+
+// Troca dois candidatos do heap mantendo o índice atualizado
+static void swap_candidates(Sketch *sketch, int a, int b) {
+    SketchCandidate tmp = sketch->candidates[a];
+    sketch->candidates[a] = sketch->candidates[b];
+    sketch->candidates[b] = tmp;
+    sketch->index[sketch->candidates[a].slot] = a;
+    sketch->index[sketch->candidates[b].slot] = b;
+}
+
+static void sift_up(Sketch *sketch, int pos) {
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (sketch->candidates[parent].estimate <= sketch->candidates[pos].estimate) break;
+        swap_candidates(sketch, parent, pos);
+        pos = parent;
+    }
+}
+
+static void sift_down(Sketch *sketch, int pos) {
+    for (;;) {
+        int smallest = pos;
+        int left = 2 * pos + 1, right = left + 1;
+        if (left < sketch->num_candidates && sketch->candidates[left].estimate < sketch->candidates[smallest].estimate) smallest = left;
+        if (right < sketch->num_candidates && sketch->candidates[right].estimate < sketch->candidates[smallest].estimate) smallest = right;
+        if (smallest == pos) break;
+        swap_candidates(sketch, smallest, pos);
+        pos = smallest;
+    }
+}
+
+// Reconstrói o índice sem as posições removidas
+static void rebuild_index(Sketch *sketch) {
+    for (int i = 0; i < SKETCH_INDEX_SIZE; i++) sketch->index[i] = INDEX_EMPTY;
+    for (int pos = 0; pos < sketch->num_candidates; pos++) {
+        size_t i = sketch->candidates[pos].hash & (SKETCH_INDEX_SIZE - 1);
+        while (sketch->index[i] != INDEX_EMPTY) i = (i + 1) & (SKETCH_INDEX_SIZE - 1);
+        sketch->index[i] = pos;
+        sketch->candidates[pos].slot = (int)i;
+    }
+    sketch->tombstones = 0;
+}
+
+// Oferece uma chave com a sua estimativa atual ao heap de candidatos
+static void offer_candidate(Sketch *sketch, uint64_t hash, const char *key, size_t len, uint64_t value) {
+    size_t stored_len = len < SKETCH_MAX_KEY ? len : SKETCH_MAX_KEY - 1;
+    int free_slot = -1;
+    size_t i = hash & (SKETCH_INDEX_SIZE - 1);
+    for (; sketch->index[i] != INDEX_EMPTY; i = (i + 1) & (SKETCH_INDEX_SIZE - 1)) {
+        int pos = sketch->index[i];
+        if (pos == INDEX_REMOVED) {
+            if (free_slot < 0) free_slot = (int)i;
+            continue;
+        }
+        SketchCandidate *candidate = &sketch->candidates[pos];
+        if (candidate->hash == hash && candidate->key_len == stored_len && memcmp(candidate->key, key, stored_len) == 0) {
+            // Já é candidato: a estimativa só cresce, então desce no heap mínimo
+            candidate->estimate = value;
+            sift_down(sketch, pos);
+            return;
+        }
+    }
+    if (free_slot < 0) free_slot = (int)i;
+
+    int pos;
+    if (sketch->num_candidates < SKETCH_CANDIDATES) {
+        pos = sketch->num_candidates++;
+    } else if (value > sketch->candidates[0].estimate) {
+        // Substitui o candidato de menor estimativa
+        pos = 0;
+        sketch->index[sketch->candidates[0].slot] = INDEX_REMOVED;
+        sketch->tombstones++;
+    } else {
+        return;
+    }
+    if (sketch->index[free_slot] == INDEX_REMOVED) sketch->tombstones--;
+
+    SketchCandidate *candidate = &sketch->candidates[pos];
+    candidate->hash = hash;
+    candidate->estimate = value;
+    candidate->key_len = (uint32_t)stored_len;
+    memcpy(candidate->key, key, stored_len);
+    candidate->key[stored_len] = '\0';
+    candidate->slot = free_slot;
+    sketch->index[free_slot] = pos;
+    if (pos == 0 && sketch->num_candidates == SKETCH_CANDIDATES) {
+        sift_down(sketch, 0);
+    } else {
+        sift_up(sketch, pos);
+    }
+    if (sketch->tombstones > SKETCH_CANDIDATES) rebuild_index(sketch);
+}
+
+// Registra ocorrências de uma chave
+void sketch_add(Sketch *sketch, const char *key, size_t len, uint64_t amount) {
+    uint64_t hash = count_table_hash(key, len);
+    uint64_t min = UINT64_MAX;
+    for (int row = 0; row < SKETCH_DEPTH; row++) {
+        uint64_t *counter = &sketch->counts[column(hash, row)];
+        *counter += amount;
+        if (*counter < min) min = *counter;
+    }
+    sketch->total += amount;
+    hll_add(sketch->registers, hash);
+
+    // Só chaves que superam o menor candidato tocam no heap
+    if (sketch->num_candidates < SKETCH_CANDIDATES || min > sketch->candidates[0].estimate) {
+        offer_candidate(sketch, hash, key, len, min);
+    }
+}
+
+// Soma outro sketch neste
+void sketch_merge(Sketch *dst, const Sketch *src) {
+    for (size_t i = 0; i < (size_t)SKETCH_DEPTH * SKETCH_WIDTH; i++) {
+        dst->counts[i] += src->counts[i];
+    }
+    dst->total += src->total;
+    for (size_t i = 0; i < SKETCH_REGISTERS; i++) {
+        if (src->registers[i] > dst->registers[i]) dst->registers[i] = src->registers[i];
+    }
+    // As estimativas dos candidatos de ambos mudaram: reavalia todos no sketch somado
+    for (int pos = 0; pos < dst->num_candidates; pos++) {
+        dst->candidates[pos].estimate = estimate(dst, dst->candidates[pos].hash);
+    }
+    for (int pos = dst->num_candidates / 2 - 1; pos >= 0; pos--) {
+        sift_down(dst, pos);
+    }
+    for (int pos = 0; pos < src->num_candidates; pos++) {
+        const SketchCandidate *candidate = &src->candidates[pos];
+        offer_candidate(dst, candidate->hash, candidate->key, candidate->key_len, estimate(dst, candidate->hash));
+    }
+}
+
+// Estimativa do HyperLogLog com a correção para poucos elementos (contagem linear)
+static double hll_estimate(const uint8_t *registers) {
+    double m = SKETCH_REGISTERS;
+    double sum = 0.0;
+    int zeros = 0;
+    for (size_t i = 0; i < SKETCH_REGISTERS; i++) {
+        sum += ldexp(1.0, -registers[i]);
+        if (registers[i] == 0) zeros++;
+    }
+    double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double raw = alpha * m * m / sum;
+    if (raw <= 2.5 * m && zeros > 0) {
+        return m * log(m / zeros);
+    }
+    return raw;
+}
+
+// Estimativa local do número de chaves distintas
+double sketch_distinct(const Sketch *sketch) {
+    return hll_estimate(sketch->registers);
+}
+
+// Junta os sketches de todos os processos no root
+CountTable* sketch_reduce(Sketch *sketch, int top_k, SketchBounds *bounds, int root, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    // Count-Min: soma posição a posição; HyperLogLog: máximo posição a posição
+    size_t cells = (size_t)SKETCH_DEPTH * SKETCH_WIDTH;
+    uint64_t *counts = NULL;
+    uint8_t *registers = NULL;
+    uint64_t total = 0;
+    if (rank == root) {
+        counts = malloc(cells * sizeof(uint64_t));
+        registers = malloc(SKETCH_REGISTERS);
+    }
+    MPI_Reduce(sketch->counts, counts, (int)cells, MPI_UINT64_T, MPI_SUM, root, comm);
+    MPI_Reduce(sketch->registers, registers, SKETCH_REGISTERS, MPI_UINT8_T, MPI_MAX, root, comm);
+    MPI_Reduce(&sketch->total, &total, 1, MPI_UINT64_T, MPI_SUM, root, comm);
+    if (rank != root) {
+        rank_stats_add(STAT_BYTES_SENT, (long long)(cells * sizeof(uint64_t) + SKETCH_REGISTERS + sizeof(uint64_t)));
+    }
+
+    // Candidatos: a união das chaves de todos os processos chega ao root
+    CountTable *keys = count_table_create(SKETCH_CANDIDATES);
+    for (int pos = 0; pos < sketch->num_candidates; pos++) {
+        count_table_add(keys, sketch->candidates[pos].key, sketch->candidates[pos].key_len, 1);
+    }
+    count_exchange_gather(keys, root, comm);
+
+    CountTable *result = NULL;
+    if (rank == root) {
+        free(sketch->counts);
+        free(sketch->registers);
+        sketch->counts = counts;
+        sketch->registers = registers;
+        sketch->total = total;
+
+        // Reavalia cada candidato no sketch global e fica com os top_k
+        CountTable *estimates = count_table_create(keys->size);
+        for (size_t i = 0; i < keys->capacity; i++) {
+            const CountSlot *slot = &keys->slots[i];
+            if (slot->hash == 0) continue;
+            uint64_t value = estimate(sketch, slot->hash);
+            count_table_add_hashed(estimates, slot->hash, count_table_key(keys, slot), slot->key_len,
+                                   value > INT_MAX ? INT_MAX : (int)value);
+        }
+        size_t *top = malloc((top_k > 0 ? top_k : 1) * sizeof(size_t));
+        size_t n = count_table_top_k(estimates, top_k, top);
+        result = count_table_create(top_k);
+        for (size_t i = 0; i < n; i++) {
+            const CountSlot *slot = &estimates->slots[top[i]];
+            count_table_add_hashed(result, slot->hash, count_table_key(estimates, slot), slot->key_len, slot->count);
+        }
+        free(top);
+        count_table_free(estimates);
+
+        // Count-Min: contagem <= estimativa <= contagem + ε·N com probabilidade 1 - δ
+        bounds->distinct = hll_estimate(sketch->registers);
+        bounds->distinct_error = 1.04 / sqrt((double)SKETCH_REGISTERS);
+        bounds->total = total;
+        bounds->count_error = (uint64_t)ceil(exp(1.0) / SKETCH_WIDTH * (double)total);
+        bounds->confidence = 1.0 - exp(-(double)SKETCH_DEPTH);
+    }
+    count_table_free(keys);
+    return result;
+}
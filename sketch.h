@@ -0,0 +1,104 @@
+#ifndef SKETCH_H
+#define SKETCH_H
+
+// Inclusão das bibliotecas necessárias
+#include <stddef.h>         // Para size_t
+#include <stdint.h>         // Para inteiros de tamanho fixo
+#include <mpi.h>            // Para juntar os sketches entre processos
+#include "count_table.h"    // Para devolver os mais frequentes e para o hash das chaves
+
+// Dimensões fixas: a memória por processo não depende do número de chaves distintas
+#define SKETCH_WIDTH (1 << 16)      // Colunas do Count-Min (erro ε = e / largura)
+#define SKETCH_DEPTH 4              // Linhas do Count-Min (confiança 1 - e^-profundidade)
+#define SKETCH_HLL_PRECISION 14     // HyperLogLog com 2^14 registradores (erro padrão 1,04 / 2^7 ≈ 0,8%)
+#define SKETCH_CANDIDATES 256       // Candidatos a mais frequentes guardados por processo
+#define SKETCH_MAX_KEY 200          // Bytes guardados de cada candidato (MAX_ARTIST_LENGTH)
+
+// Candidato a mais frequente: chave e estimativa atual do Count-Min
+typedef struct {
+    uint64_t hash;               // Hash da chave (count_table_hash)
+    uint64_t estimate;           // Estimativa do Count-Min na última vez que a chave apareceu
+    uint32_t key_len;            // Tamanho guardado da chave
+    int slot;                    // Posição no índice por hash
+    char key[SKETCH_MAX_KEY];    // Chave (truncada em SKETCH_MAX_KEY - 1 bytes)
+} SketchCandidate;
+
+// Contagem aproximada com memória fixa:
+//   Count-Min: SKETCH_DEPTH linhas de SKETCH_WIDTH contadores; a estimativa de uma chave é
+//   o menor dos seus contadores e nunca fica abaixo da contagem real
+//   candidatos: heap mínimo com as SKETCH_CANDIDATES chaves de maior estimativa já vistas
+//   HyperLogLog: registradores com o maior número de zeros iniciais visto em cada balde,
+//   para estimar o número de chaves distintas
+// Os contadores se juntam somando posição a posição e os registradores pelo máximo.
+typedef struct {
+    uint64_t *counts;                    // Count-Min (SKETCH_DEPTH x SKETCH_WIDTH)
+    uint64_t total;                      // Soma de todas as ocorrências (N)
+    uint8_t *registers;                  // HyperLogLog (2^SKETCH_HLL_PRECISION)
+    SketchCandidate *candidates;         // Heap mínimo por estimativa
+    int num_candidates;
+    int *index;                          // Hash -> posição no heap (sondagem linear)
+    int tombstones;                      // Posições removidas do índice
+} Sketch;
+
+// Limites de erro reportados junto com os resultados aproximados
+typedef struct {
+    double distinct;           // Estimativa do número de chaves distintas (HyperLogLog)
+    double distinct_error;     // Erro padrão relativo da estimativa acima
+    uint64_t total;            // Total de ocorrências (N)
+    uint64_t count_error;      // Superestimativa máxima de uma contagem: ε·N
+    double confidence;         // Probabilidade de a superestimativa ficar abaixo de ε·N
+} SketchBounds;
+
+// Declarações das funções
+
+/**
+ * Cria um sketch vazio
+ * @return Ponteiro para Sketch alocado
+ */
+Sketch* sketch_create(void);
+
+/**
+ * Libera a memória do sketch
+ * @param sketch Ponteiro para Sketch a ser liberado
+ */
+void sketch_free(Sketch *sketch);
+
+/**
+ * Registra ocorrências de uma chave
+ * @param sketch Sketch a atualizar
+ * @param key Chave
+ * @param len Tamanho da chave
+ * @param amount Número de ocorrências
+ */
+void sketch_add(Sketch *sketch, const char *key, size_t len, uint64_t amount);
+
+/**
+ * Soma outro sketch (de uma thread) neste; os candidatos do outro são reavaliados
+ * @param dst Sketch que recebe a soma
+ * @param src Sketch somado (não é alterado)
+ */
+void sketch_merge(Sketch *dst, const Sketch *src);
+
+/**
+ * Estimativa local do número de chaves distintas (HyperLogLog)
+ * @param sketch Sketch
+ * @return Estimativa
+ */
+double sketch_distinct(const Sketch *sketch);
+
+/**
+ * Junta os sketches de todos os processos no root. Como todos têm o mesmo tamanho fixo,
+ * a junção é elemento a elemento (MPI_Reduce: soma do Count-Min e máximo do HyperLogLog),
+ * e os candidatos de todos os processos são reavaliados no sketch global, já que a
+ * estimativa local de cada um só via as ocorrências do próprio processo.
+ * Operação coletiva; o sketch do root passa a ser o global
+ * @param sketch Sketch local
+ * @param top_k Número de chaves mais frequentes devolvidas
+ * @param bounds Saída no root: estimativa de distintas e limites de erro
+ * @param root Processo que recebe o resultado
+ * @param comm Comunicador MPI
+ * @return No root, tabela com as top_k chaves e suas estimativas; NULL nos demais
+ */
+CountTable* sketch_reduce(Sketch *sketch, int top_k, SketchBounds *bounds, int root, MPI_Comm comm);
+
+#endif // SKETCH_H
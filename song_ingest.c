@@ -0,0 +1,42 @@
+// Conversão única do CSV "artista|música|letra" para o arquivo colunar lido com --store
+#include <stdio.h>       // Para entrada e saída padrão
+#include <stdlib.h>      // Para funções de alocação de memória
+#include <string.h>      // Para manipulação de strings
+#include "song_store.h"  // Para o formato colunar
+
+int main(int argc, char *argv[]) {
+    if (argc < 2 || argc > 3) {
+        printf("Uso: %s <arquivo.csv> [saída%s]\n", argv[0], SONG_STORE_SUFFIX);
+        return 1;
+    }
+
+    // Saída padrão: o nome do CSV com o sufixo do formato colunar
+    const char *csv_filename = argv[1];
+    char *store_filename;
+    if (argc == 3) {
+        store_filename = strdup(argv[2]);
+    } else {
+        size_t len = strlen(csv_filename) + strlen(SONG_STORE_SUFFIX) + 1;
+        store_filename = malloc(len);
+        snprintf(store_filename, len, "%s%s", csv_filename, SONG_STORE_SUFFIX);
+    }
+
+    long long records = song_store_ingest(csv_filename, store_filename);
+    if (records < 0) {
+        printf("Erro: não foi possível converter %s para %s\n", csv_filename, store_filename);
+        free(store_filename);
+        return 1;
+    }
+
+    SongStore *store = song_store_open(store_filename);
+    if (!store) {
+        printf("Erro: o arquivo gerado %s não passou na validação\n", store_filename);
+        free(store_filename);
+        return 1;
+    }
+    printf("%s: %lld músicas, %llu artistas, %zu bytes\n", store_filename, records,
+           (unsigned long long)store->header->num_artists, store->size);
+    song_store_close(store);
+    free(store_filename);
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "song_source.h"
+#include <stdlib.h>    // Para funções de alocação de memória
+#include <string.h>    // Para memchr
+#include <fcntl.h>     // Para open
+#include <unistd.h>    // Para close
+#include <sys/mman.h>  // Para mmap e munmap
+#include <sys/stat.h>  // Para obter o tamanho do arquivo
+
+// Separa uma linha "artista|música|letra" em uma visão sem copiar os dados
+int song_view_parse(const char *line, size_t len, SongView *view) {
+    const char *end = line + len;
+
+    // Procura o primeiro separador (fim do artista)
+    const char *song_start = memchr(line, '|', len);
+    if (!song_start) return -1;
+    song_start++;
+
+    // Procura o segundo separador (fim do nome da música)
+    const char *text_start = memchr(song_start, '|', end - song_start);
+    if (!text_start) return -1;
+    text_start++;
+
+    view->artist = line;
+    view->artist_len = (int)(song_start - 1 - line);
+    view->song = song_start;
+    view->song_len = (int)(text_start - 1 - song_start);
+    view->text = text_start;
+    view->text_len = (int)(end - text_start);
+    return 0;
+}
+
+// Mapeia o arquivo CSV inteiro em memória
+MappedCsv* mapped_csv_open(const char *filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // O mapeamento continua válido após fechar o descritor
+    if (data == MAP_FAILED) return NULL;
+
+    MappedCsv *csv = malloc(sizeof(MappedCsv));
+    csv->data = data;
+    csv->size = (size_t)st.st_size;
+    return csv;
+}
+
+// Preenche visões para um intervalo de linhas do arquivo mapeado
+int mapped_csv_read_chunk(const MappedCsv *csv, const LineIndex *index, int start_line, int num_lines, SongView *views) {
+    int count = 0;
+    int end_line = start_line + num_lines;
+    if (end_line > index->num_lines) end_line = index->num_lines;
+
+    for (int line = start_line; line < end_line; line++) {
+        long long begin = index->offsets[line];
+        long long end = index->offsets[line + 1];
+        if (end > (long long)csv->size) end = (long long)csv->size;
+        if (begin >= end) continue;
+
+        // Remove a quebra de linha do final
+        size_t len = (size_t)(end - begin);
+        if (csv->data[begin + len - 1] == '\n') len--;
+
+        if (song_view_parse(csv->data + begin, len, &views[count]) == 0) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+// Desfaz o mapeamento e libera a estrutura
+void mapped_csv_close(MappedCsv *csv) {
+    if (csv) {
+        munmap((void *)csv->data, csv->size);  // Desfaz o mapeamento
+        free(csv);                              // Libera a estrutura principal
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef SONG_SOURCE_H
+#define SONG_SOURCE_H
+
+// Inclusão das bibliotecas necessárias
+#include <stddef.h>       // Para size_t
+#include "line_index.h"   // Para localizar as linhas no arquivo mapeado
+
+// Visão de uma música: ponteiros e tamanhos emprestados de um buffer externo
+// (arquivo mapeado ou buffer de leitura). Os campos NÃO terminam em '\0'.
+typedef struct {
+    const char *artist;  // Início do nome do artista
+    int artist_len;      // Tamanho do nome do artista
+    const char *song;    // Início do nome da música
+    int song_len;        // Tamanho do nome da música
+    const char *text;    // Início da letra
+    int text_len;        // Tamanho da letra
+} SongView;
+
+// Arquivo CSV mapeado em memória (somente leitura)
+typedef struct {
+    const char *data;  // Início do mapeamento
+    size_t size;       // Tamanho do arquivo mapeado
+} MappedCsv;
+
+// Declarações das funções
+
+/**
+ * Separa uma linha "artista|música|letra" em uma visão sem copiar os dados
+ * @param line Início da linha
+ * @param len Tamanho da linha (sem contar o '\n')
+ * @param view Visão a ser preenchida
+ * @return 0 em caso de sucesso, -1 se a linha não tiver os separadores
+ */
+int song_view_parse(const char *line, size_t len, SongView *view);
+
+/**
+ * Mapeia o arquivo CSV inteiro em memória
+ * @param filename Caminho do arquivo CSV
+ * @return Ponteiro para MappedCsv alocado, ou NULL em caso de erro
+ */
+MappedCsv* mapped_csv_open(const char *filename);
+
+/**
+ * Preenche visões para um intervalo de linhas do arquivo mapeado
+ * @param csv Arquivo mapeado
+ * @param index Índice de linhas do mesmo arquivo
+ * @param start_line Primeira linha de dados do intervalo
+ * @param num_lines Número de linhas desejadas
+ * @param views Vetor com espaço para num_lines visões
+ * @return Número de visões preenchidas (linhas malformadas são ignoradas)
+ */
+int mapped_csv_read_chunk(const MappedCsv *csv, const LineIndex *index, int start_line, int num_lines, SongView *views);
+
+/**
+ * Desfaz o mapeamento e libera a estrutura
+ * @param csv Ponteiro para MappedCsv a ser liberado
+ */
+void mapped_csv_close(MappedCsv *csv);
+
+#endif // SONG_SOURCE_H
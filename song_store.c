@@ -0,0 +1,264 @@
+#include "song_store.h"
+#include <stdio.h>       // Para gravar o arquivo colunar
+#include <stdlib.h>      // Para funções de alocação de memória
+#include <string.h>      // Para memchr e memcmp
+#include <limits.h>      // Para INT_MAX
+#include <fcntl.h>       // Para open
+#include <unistd.h>      // Para close
+#include <sys/mman.h>    // Para mmap e munmap
+#include <sys/stat.h>    // Para obter o tamanho do arquivo
+#include "count_table.h" // Para o dicionário de artistas
+
+#define SONG_STORE_WRITE_BUFFER (4 * 1024 * 1024)  // Buffer de escrita da conversão
+
+// Texto de uma coluna durante a conversão (aponta para o CSV mapeado)
+typedef struct {
+    const char *data;
+    int len;
+} IngestText;
+
+// Colunas montadas durante a conversão
+typedef struct {
+    IngestText *artists;  // Dicionário: nome de cada artista, na ordem dos ids
+    uint32_t *artist_ids; // Artista de cada música
+    IngestText *titles;   // Título de cada música
+    IngestText *lyrics;   // Letra de cada música
+    size_t num_artists, artist_capacity;
+    size_t count, capacity;
+} IngestColumns;
+
+// Grava bytes e avança a posição atual do arquivo
+static int write_bytes(FILE *file, const void *data, size_t size, uint64_t *position) {
+    if (size > 0 && fwrite(data, 1, size, file) != size) return -1;
+    *position += size;
+    return 0;
+}
+
+// Completa com zeros até a próxima posição múltipla de 8
+static int write_padding(FILE *file, uint64_t *position) {
+    static const char zeros[8] = {0};
+    return write_bytes(file, zeros, (8 - (*position & 7)) & 7, position);
+}
+
+// Grava uma coluna de textos: offsets (count + 1) seguidos dos bytes concatenados
+static int write_text_column(FILE *file, const IngestText *texts, size_t count,
+                             uint64_t *offsets_at, uint64_t *blob_at, uint64_t *position) {
+    if (write_padding(file, position) != 0) return -1;
+    *offsets_at = *position;
+    uint64_t offset = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (write_bytes(file, &offset, sizeof(offset), position) != 0) return -1;
+        offset += (uint64_t)texts[i].len;
+    }
+    if (write_bytes(file, &offset, sizeof(offset), position) != 0) return -1;
+
+    *blob_at = *position;
+    for (size_t i = 0; i < count; i++) {
+        if (write_bytes(file, texts[i].data, texts[i].len, position) != 0) return -1;
+    }
+    return 0;
+}
+
+// Grava o arquivo colunar completo; o cabeçalho é regravado no fim com as posições
+static int write_store(FILE *file, const IngestColumns *columns, uint64_t source_size) {
+    SongStoreHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SONG_STORE_MAGIC, sizeof(header.magic));
+    header.num_records = columns->count;
+    header.num_artists = columns->num_artists;
+    header.source_size = source_size;
+
+    uint64_t position = 0;
+    if (write_bytes(file, &header, sizeof(header), &position) != 0 ||
+        write_text_column(file, columns->artists, columns->num_artists, &header.artist_offsets, &header.artist_names, &position) != 0 ||
+        write_padding(file, &position) != 0) {
+        return -1;
+    }
+    header.artist_ids = position;
+    if (write_bytes(file, columns->artist_ids, columns->count * sizeof(uint32_t), &position) != 0 ||
+        write_text_column(file, columns->titles, columns->count, &header.title_offsets, &header.titles, &position) != 0 ||
+        write_text_column(file, columns->lyrics, columns->count, &header.lyric_offsets, &header.lyrics, &position) != 0) {
+        return -1;
+    }
+    header.file_size = position;
+
+    if (fseek(file, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, file) != 1) return -1;
+    return 0;
+}
+
+// Converte o CSV para o formato colunar
+long long song_store_ingest(const char *csv_filename, const char *store_filename) {
+    MappedCsv *csv = mapped_csv_open(csv_filename);
+    if (!csv) return -1;
+
+    // Pula o cabeçalho
+    const char *p = memchr(csv->data, '\n', csv->size);
+    const char *end = csv->data + csv->size;
+    p = p ? p + 1 : end;
+
+    IngestColumns columns;
+    columns.capacity = 1024;
+    columns.count = 0;
+    columns.artist_capacity = 1024;
+    columns.num_artists = 0;
+    columns.artists = malloc(columns.artist_capacity * sizeof(IngestText));
+    columns.artist_ids = malloc(columns.capacity * sizeof(uint32_t));
+    columns.titles = malloc(columns.capacity * sizeof(IngestText));
+    columns.lyrics = malloc(columns.capacity * sizeof(IngestText));
+    CountTable *dictionary = count_table_create(4096);
+
+    // Separa cada linha uma única vez; linhas malformadas são ignoradas, como na leitura do CSV
+    while (p < end) {
+        const char *newline = memchr(p, '\n', end - p);
+        const char *line_end = newline ? newline : end;
+        SongView view;
+        if (song_view_parse(p, line_end - p, &view) == 0) {
+            // Dicionário: a contagem guarda id + 1 de cada artista já visto
+            int id = count_table_get(dictionary, view.artist, view.artist_len) - 1;
+            if (id < 0) {
+                id = (int)columns.num_artists;
+                count_table_add(dictionary, view.artist, view.artist_len, id + 1);
+                if (columns.num_artists == columns.artist_capacity) {
+                    columns.artist_capacity *= 2;
+                    columns.artists = realloc(columns.artists, columns.artist_capacity * sizeof(IngestText));
+                }
+                columns.artists[columns.num_artists].data = view.artist;
+                columns.artists[columns.num_artists].len = view.artist_len;
+                columns.num_artists++;
+            }
+
+            if (columns.count == columns.capacity) {
+                columns.capacity *= 2;
+                columns.artist_ids = realloc(columns.artist_ids, columns.capacity * sizeof(uint32_t));
+                columns.titles = realloc(columns.titles, columns.capacity * sizeof(IngestText));
+                columns.lyrics = realloc(columns.lyrics, columns.capacity * sizeof(IngestText));
+            }
+            columns.artist_ids[columns.count] = (uint32_t)id;
+            columns.titles[columns.count].data = view.song;
+            columns.titles[columns.count].len = view.song_len;
+            columns.lyrics[columns.count].data = view.text;
+            columns.lyrics[columns.count].len = view.text_len;
+            columns.count++;
+        }
+        p = line_end + 1;
+    }
+    count_table_free(dictionary);
+
+    long long result = -1;
+    FILE *file = fopen(store_filename, "wb");
+    if (file) {
+        char *buffer = malloc(SONG_STORE_WRITE_BUFFER);
+        setvbuf(file, buffer, _IOFBF, SONG_STORE_WRITE_BUFFER);
+        if (write_store(file, &columns, csv->size) == 0) {
+            result = (long long)columns.count;
+        }
+        if (fclose(file) != 0) result = -1;
+        free(buffer);
+        if (result < 0) remove(store_filename);  // Não deixa um arquivo pela metade
+    }
+
+    free(columns.artists);
+    free(columns.artist_ids);
+    free(columns.titles);
+    free(columns.lyrics);
+    mapped_csv_close(csv);
+    return result;
+}
+
+// Verifica se uma seção de 'bytes' bytes começando em 'at' cabe no arquivo
+static int section_fits(uint64_t at, uint64_t bytes, size_t size) {
+    return at <= size && bytes <= size - at;
+}
+
+// Verifica se os count + 1 offsets de uma coluna nunca diminuem e se cada campo
+// cabe no int das visões. Com o último offset já limitado ao tamanho da seção,
+// isso garante que todo campo fica dentro da coluna.
+static int offsets_valid(const uint64_t *offsets, uint64_t count) {
+    for (uint64_t i = 0; i < count; i++) {
+        if (offsets[i + 1] < offsets[i] || offsets[i + 1] - offsets[i] > INT_MAX) return 0;
+    }
+    return 1;
+}
+
+// Mapeia um arquivo colunar e valida o cabeçalho
+SongStore* song_store_open(const char *filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SongStoreHeader)) {
+        close(fd);
+        return NULL;
+    }
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return NULL;
+
+    size_t size = (size_t)st.st_size;
+    const SongStoreHeader *header = (const SongStoreHeader *)data;
+    const char *base = (const char *)data;
+    int valid = memcmp(header->magic, SONG_STORE_MAGIC, sizeof(header->magic)) == 0 &&
+                header->file_size == size && header->num_records <= INT_MAX && header->num_artists <= UINT32_MAX &&
+                section_fits(header->artist_offsets, (header->num_artists + 1) * sizeof(uint64_t), size) &&
+                section_fits(header->artist_ids, header->num_records * sizeof(uint32_t), size) &&
+                section_fits(header->title_offsets, (header->num_records + 1) * sizeof(uint64_t), size) &&
+                section_fits(header->lyric_offsets, (header->num_records + 1) * sizeof(uint64_t), size);
+    // O último offset de cada coluna marca o tamanho dos bytes concatenados
+    valid = valid &&
+            section_fits(header->artist_names, ((const uint64_t *)(base + header->artist_offsets))[header->num_artists], size) &&
+            section_fits(header->titles, ((const uint64_t *)(base + header->title_offsets))[header->num_records], size) &&
+            section_fits(header->lyrics, ((const uint64_t *)(base + header->lyric_offsets))[header->num_records], size);
+    // Offsets fora de ordem levariam a comprimentos negativos ou leituras fora da coluna
+    valid = valid &&
+            offsets_valid((const uint64_t *)(base + header->artist_offsets), header->num_artists) &&
+            offsets_valid((const uint64_t *)(base + header->title_offsets), header->num_records) &&
+            offsets_valid((const uint64_t *)(base + header->lyric_offsets), header->num_records);
+    if (!valid) {
+        munmap(data, size);
+        return NULL;
+    }
+
+    SongStore *store = malloc(sizeof(SongStore));
+    store->data = base;
+    store->size = size;
+    store->header = header;
+    store->artist_offsets = (const uint64_t *)(base + header->artist_offsets);
+    store->artist_names = base + header->artist_names;
+    store->artist_ids = (const uint32_t *)(base + header->artist_ids);
+    store->title_offsets = (const uint64_t *)(base + header->title_offsets);
+    store->titles = base + header->titles;
+    store->lyric_offsets = (const uint64_t *)(base + header->lyric_offsets);
+    store->lyrics = base + header->lyrics;
+    store->num_records = (int)header->num_records;
+    return store;
+}
+
+// Preenche visões para um intervalo de músicas
+int song_store_read_chunk(const SongStore *store, int start, int count, SongView *views) {
+    int filled = 0;
+    int end = start + count;
+    if (start < 0) start = 0;
+    if (end > store->num_records) end = store->num_records;
+
+    for (int i = start; i < end; i++) {
+        uint32_t artist = store->artist_ids[i];
+        if (artist >= store->header->num_artists) continue;  // Id fora do dicionário
+
+        SongView *view = &views[filled++];
+        view->artist = store->artist_names + store->artist_offsets[artist];
+        view->artist_len = (int)(store->artist_offsets[artist + 1] - store->artist_offsets[artist]);
+        view->song = store->titles + store->title_offsets[i];
+        view->song_len = (int)(store->title_offsets[i + 1] - store->title_offsets[i]);
+        view->text = store->lyrics + store->lyric_offsets[i];
+        view->text_len = (int)(store->lyric_offsets[i + 1] - store->lyric_offsets[i]);
+    }
+    return filled;
+}
+
+// Desfaz o mapeamento e libera a estrutura
+void song_store_close(SongStore *store) {
+    if (store) {
+        munmap((void *)store->data, store->size);
+        free(store);
+    }
+}
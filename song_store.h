@@ -0,0 +1,81 @@
+#ifndef SONG_STORE_H
+#define SONG_STORE_H
+
+// Inclusão das bibliotecas necessárias
+#include <stddef.h>         // Para size_t
+#include <stdint.h>         // Para inteiros de tamanho fixo
+#include "song_source.h"    // Para SongView
+
+#define SONG_STORE_MAGIC "SONGCOL1"   // Identificador do formato (e da versão)
+#define SONG_STORE_SUFFIX ".songs"    // Sufixo sugerido para os arquivos gerados
+
+// Cabeçalho do arquivo colunar. Todas as seções começam em offsets múltiplos de 8:
+//   artistas: uint64 offsets[num_artists + 1] + nomes concatenados
+//   artista de cada música: uint32 ids[num_records] (dicionário acima)
+//   títulos: uint64 offsets[num_records + 1] + títulos concatenados
+//   letras: uint64 offsets[num_records + 1] + letras concatenadas
+typedef struct {
+    char magic[8];                  // SONG_STORE_MAGIC
+    uint64_t num_records;           // Número de músicas
+    uint64_t num_artists;           // Número de artistas distintos
+    uint64_t artist_offsets;        // Posição dos offsets do dicionário de artistas
+    uint64_t artist_names;          // Posição dos nomes dos artistas
+    uint64_t artist_ids;            // Posição do id de artista de cada música
+    uint64_t title_offsets;         // Posição dos offsets dos títulos
+    uint64_t titles;                // Posição dos títulos
+    uint64_t lyric_offsets;         // Posição dos offsets das letras
+    uint64_t lyrics;                // Posição das letras
+    uint64_t source_size;           // Tamanho do CSV de origem
+    uint64_t file_size;             // Tamanho total do arquivo (detecta cópias truncadas)
+} SongStoreHeader;
+
+// Arquivo colunar mapeado em memória. A música i é montada em O(1) a partir das
+// colunas, sem procurar separadores nem contar linhas.
+typedef struct {
+    const char *data;               // Início do mapeamento
+    size_t size;                    // Tamanho do arquivo
+    const SongStoreHeader *header;  // Cabeçalho (início do mapeamento)
+    const uint64_t *artist_offsets; // Dicionário de artistas
+    const char *artist_names;
+    const uint32_t *artist_ids;     // Artista de cada música
+    const uint64_t *title_offsets;  // Coluna de títulos
+    const char *titles;
+    const uint64_t *lyric_offsets;  // Coluna de letras
+    const char *lyrics;
+    int num_records;                // Número de músicas
+} SongStore;
+
+// Declarações das funções
+
+/**
+ * Converte o CSV "artista|música|letra" (com cabeçalho) para o formato colunar
+ * @param csv_filename Caminho do CSV de origem
+ * @param store_filename Caminho do arquivo colunar a gerar
+ * @return Número de músicas gravadas, ou -1 em caso de erro
+ */
+long long song_store_ingest(const char *csv_filename, const char *store_filename);
+
+/**
+ * Mapeia um arquivo colunar e valida o cabeçalho
+ * @param filename Caminho do arquivo colunar
+ * @return Ponteiro para SongStore alocado, ou NULL se o arquivo não existir ou for inválido
+ */
+SongStore* song_store_open(const char *filename);
+
+/**
+ * Preenche visões para um intervalo de músicas (acesso direto pelo índice)
+ * @param store Arquivo colunar
+ * @param start Primeira música do intervalo
+ * @param count Número de músicas desejadas
+ * @param views Vetor com espaço para count visões
+ * @return Número de visões preenchidas
+ */
+int song_store_read_chunk(const SongStore *store, int start, int count, SongView *views);
+
+/**
+ * Desfaz o mapeamento e libera a estrutura
+ * @param store Ponteiro para SongStore a ser liberado
+ */
+void song_store_close(SongStore *store);
+
+#endif // SONG_STORE_H
@@ -0,0 +1,421 @@
+#include "song_stream.h"
+#include <stdio.h>           // Para printf e a exportação dos snapshots
+#include <stdlib.h>          // Para funções de alocação de memória
+#include <string.h>          // Para memchr, memcpy e strcmp
+#include <errno.h>           // Para EINTR
+#include <fcntl.h>           // Para open
+#include <poll.h>            // Para esperar dados do pipe com limite de tempo
+#include <unistd.h>          // Para read, close e usleep
+#include <sys/stat.h>        // Para distinguir arquivo comum de pipe
+#include "analyzer.h"        // Para os contadores de palavras e artistas
+#include "count_exchange.h"  // Para juntar os deltas no processo 0
+#include "rank_stats.h"      // Para a instrumentação por processo
+
+#define STREAM_READ_SIZE (64 * 1024)   // Bytes pedidos a cada read
+#define STREAM_POLL_STEP 0.02          // Espera entre tentativas no fim de um arquivo seguido
+#define STREAM_HEADER "artist|song|text"  // Cabeçalho do CSV (ignorado se vier na entrada)
+
+#define FLAG_SNAPSHOT 1   // O lote termina com um snapshot
+#define FLAG_FINISHED 2   // Último lote: a entrada acabou
+
+// Entrada contínua lida pelo processo 0 (pipe, entrada padrão ou arquivo que cresce)
+typedef struct {
+    int fd;            // Descritor da entrada
+    int is_regular;    // 1 = arquivo comum (poll não serve: está sempre pronto)
+    int follow;        // 1 = no fim do arquivo, espera novas linhas
+    int eof;           // Fim da entrada alcançado
+    char *data;        // Bytes lidos e ainda não entregues
+    size_t start;      // Início da próxima linha em data
+    size_t end;        // Fim dos bytes válidos em data
+    size_t capacity;   // Bytes alocados para data
+} StreamReader;
+
+// Lote montado pelo processo 0: linhas terminadas em '\n', contíguas
+typedef struct {
+    char *data;        // Bytes das linhas
+    size_t used;       // Bytes ocupados
+    size_t capacity;   // Bytes alocados
+    size_t *ends;      // Fim (exclusivo) de cada linha em data
+    int count;         // Linhas no lote
+} StreamBatch;
+
+// Abre a entrada contínua ("-" = entrada padrão)
+static StreamReader* reader_open(const char *source, int follow) {
+    int fd = strcmp(source, "-") == 0 ? STDIN_FILENO : open(source, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    StreamReader *reader = malloc(sizeof(StreamReader));
+    reader->fd = fd;
+    reader->is_regular = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+    reader->follow = follow && reader->is_regular;  // Pipes só terminam quando o escritor fecha
+    reader->eof = 0;
+    reader->capacity = 4 * STREAM_READ_SIZE;
+    reader->data = malloc(reader->capacity);
+    reader->start = 0;
+    reader->end = 0;
+    return reader;
+}
+
+// Fecha a entrada contínua
+static void reader_close(StreamReader *reader) {
+    if (reader) {
+        if (reader->fd != STDIN_FILENO) close(reader->fd);
+        free(reader->data);
+        free(reader);
+    }
+}
+
+// Lê mais bytes até o prazo: 1 se leu, 0 se o prazo acabou, -1 no fim da entrada
+static int reader_fill(StreamReader *reader, double deadline) {
+    // Descarta as linhas já entregues e garante espaço para mais uma leitura
+    if (reader->start > 0) {
+        memmove(reader->data, reader->data + reader->start, reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
+    }
+    if (reader->capacity - reader->end < STREAM_READ_SIZE) {
+        while (reader->capacity - reader->end < STREAM_READ_SIZE) reader->capacity *= 2;
+        reader->data = realloc(reader->data, reader->capacity);
+    }
+
+    for (;;) {
+        if (!reader->is_regular) {
+            double wait = deadline - MPI_Wtime();
+            struct pollfd pfd = { reader->fd, POLLIN, 0 };
+            int ready = poll(&pfd, 1, wait > 0.0 ? (int)(wait * 1000.0) : 0);
+            if (ready < 0 && errno == EINTR) continue;
+            if (ready == 0) return 0;
+        }
+        ssize_t n = read(reader->fd, reader->data + reader->end, reader->capacity - reader->end);
+        if (n > 0) {
+            reader->end += (size_t)n;
+            rank_stats_add(STAT_BYTES_READ, n);
+            return 1;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n == 0 && reader->follow) {
+            // Arquivo seguido: novas linhas podem ser acrescentadas a qualquer momento
+            double wait = deadline - MPI_Wtime();
+            if (wait <= 0.0) return 0;
+            usleep((useconds_t)((wait < STREAM_POLL_STEP ? wait : STREAM_POLL_STEP) * 1e6));
+            continue;
+        }
+        reader->eof = 1;
+        return -1;
+    }
+}
+
+// Próxima linha completa (sem '\n' nem '\r'): 1 se há linha, 0 se o prazo acabou, -1 no fim.
+// A linha só vale até a próxima chamada.
+static int reader_next(StreamReader *reader, const char **line, size_t *len, double deadline) {
+    for (;;) {
+        char *start = reader->data + reader->start;
+        char *newline = memchr(start, '\n', reader->end - reader->start);
+        if (newline || (reader->eof && reader->start < reader->end)) {
+            // No fim da entrada a última linha pode vir sem '\n'
+            size_t line_len = newline ? (size_t)(newline - start) : reader->end - reader->start;
+            reader->start += line_len + (newline ? 1 : 0);
+            if (line_len > 0 && start[line_len - 1] == '\r') line_len--;
+            *line = start;
+            *len = line_len;
+            return 1;
+        }
+        if (reader->eof) return -1;
+        if (reader_fill(reader, deadline) == 0) return 0;
+    }
+}
+
+// Acrescenta uma linha (com '\n') ao lote
+static void batch_add(StreamBatch *batch, const char *line, size_t len, int max_lines) {
+    if (batch->used + len + 1 > batch->capacity) {
+        while (batch->used + len + 1 > batch->capacity) batch->capacity *= 2;
+        batch->data = realloc(batch->data, batch->capacity);
+    }
+    memcpy(batch->data + batch->used, line, len);
+    batch->data[batch->used + len] = '\n';
+    batch->used += len + 1;
+    if (batch->count < max_lines) batch->ends[batch->count++] = batch->used;
+}
+
+// Escreve uma string JSON, escapando aspas, barras e caracteres de controle
+static void write_json_string(FILE *file, const char *text) {
+    fputc('"', file);
+    for (const unsigned char *p = (const unsigned char *)text; *p; p++) {
+        if (*p == '"' || *p == '\\') fprintf(file, "\\%c", *p);
+        else if (*p < 0x20) fprintf(file, "\\u%04x", *p);
+        else fputc(*p, file);
+    }
+    fputc('"', file);
+}
+
+// Escreve o top-K de uma tabela como vetor JSON de {"key", "count"}
+static void write_json_top(FILE *file, const CountTable *table) {
+    size_t top[TOP_K];
+    size_t n = count_table_top_k(table, TOP_K, top);
+    fprintf(file, "[");
+    for (size_t i = 0; i < n; i++) {
+        const CountSlot *slot = &table->slots[top[i]];
+        fprintf(file, "%s{\"key\": ", i > 0 ? ", " : "");
+        write_json_string(file, count_table_key(table, slot));
+        fprintf(file, ", \"count\": %d}", slot->count);
+    }
+    fprintf(file, "]");
+}
+
+// Regrava o JSON do snapshot (arquivo temporário + rename: quem lê nunca vê um arquivo pela metade)
+static int write_snapshot_json(const char *path, int number, int final, double elapsed, long long songs,
+                               const CountTable *words, const CountTable *artists) {
+    size_t path_len = strlen(path);
+    char *temp_path = malloc(path_len + 5);
+    memcpy(temp_path, path, path_len);
+    memcpy(temp_path + path_len, ".tmp", 5);
+
+    FILE *file = fopen(temp_path, "w");
+    if (!file) {
+        free(temp_path);
+        return -1;
+    }
+    fprintf(file, "{\n  \"snapshot\": %d,\n  \"final\": %s,\n  \"elapsed_seconds\": %.3f,\n", number, final ? "true" : "false", elapsed);
+    fprintf(file, "  \"songs\": %lld,\n  \"songs_per_second\": %.1f,\n", songs, elapsed > 0.0 ? songs / elapsed : 0.0);
+    fprintf(file, "  \"unique_words\": %zu,\n  \"unique_artists\": %zu,\n", words->size, artists->size);
+    fprintf(file, "  \"top_words\": ");
+    write_json_top(file, words);
+    fprintf(file, ",\n  \"top_artists\": ");
+    write_json_top(file, artists);
+    fprintf(file, "\n}\n");
+    int status = fclose(file) == 0 && rename(temp_path, path) == 0 ? 0 : -1;
+    free(temp_path);
+    return status;
+}
+
+// Imprime o top-K de uma tabela numa linha ("chave (contagem), ...")
+static void print_top_line(const char *title, const CountTable *table) {
+    size_t top[TOP_K];
+    size_t n = count_table_top_k(table, TOP_K, top);
+    printf("  %s:", title);
+    for (size_t i = 0; i < n; i++) {
+        const CountSlot *slot = &table->slots[top[i]];
+        printf("%s %s (%d)", i > 0 ? "," : "", count_table_key(table, slot), slot->count);
+    }
+    printf("\n");
+}
+
+// Resultados finais no mesmo formato do modo arquivo
+static void print_final(const CountTable *words, const CountTable *artists, long long songs, double elapsed) {
+    size_t top[TOP_K];
+    printf("\n");
+    printf("========================================\n");
+    printf("FINAL RESULTS SUMMARY - STREAM\n");
+    printf("========================================\n");
+    printf("Songs analyzed: %lld in %.1f s\n", songs, elapsed);
+
+    printf("\n1. WORD COUNTING:\n");
+    printf("Total unique words found: %zu\n", words->size);
+    printf("Top 10 most frequent words:\n");
+    size_t n = count_table_top_k(words, TOP_K, top);
+    for (size_t i = 0; i < n; i++) {
+        const CountSlot *slot = &words->slots[top[i]];
+        printf("  %zu. %s: %d occurrences\n", i + 1, count_table_key(words, slot), slot->count);
+    }
+
+    printf("\n2. ARTIST ANALYSIS:\n");
+    printf("Total unique artists found: %zu\n", artists->size);
+    printf("Top 10 artists with most songs:\n");
+    n = count_table_top_k(artists, TOP_K, top);
+    for (size_t i = 0; i < n; i++) {
+        const CountSlot *slot = &artists->slots[top[i]];
+        printf("  %zu. %s: %d songs\n", i + 1, count_table_key(artists, slot), slot->count);
+    }
+
+    printf("\n Analysis completed successfully!\n");
+}
+
+// Modo contínuo: lotes distribuídos com MPI_Scatterv e snapshots dos deltas
+long long song_stream_run(const StreamConfig *config, int world_rank, int world_size) {
+    // O processo 0 abre a entrada e avisa os demais se não conseguiu
+    StreamReader *reader = NULL;
+    int opened = 1;
+    if (world_rank == 0) {
+        reader = reader_open(config->source, config->follow);
+        if (!reader) {
+            printf("Erro: não foi possível abrir a entrada contínua %s\n", config->source);
+            opened = 0;
+        } else {
+            printf("Modo contínuo: lendo %s%s, lotes de até %d linhas por processo, snapshot a cada %.1f s\n",
+                   strcmp(config->source, "-") == 0 ? "a entrada padrão" : config->source,
+                   reader->follow ? " (seguindo o arquivo)" : "", STREAM_BATCH_LINES, config->snapshot_interval);
+        }
+    }
+    MPI_Bcast(&opened, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (!opened) return -1;
+
+    // Contagens desde o último snapshot (deltas); o processo 0 acumula o total
+    WordCounter *words = word_counter_create(0);
+    ArtistCounter *artists = artist_counter_create(0);
+    CountTable *total_words = NULL;
+    CountTable *total_artists = NULL;
+    long long total_songs = 0;
+    long long delta_songs = 0;
+    int snapshot_number = 0;
+
+    int max_lines = STREAM_BATCH_LINES * world_size;
+    StreamBatch batch = { NULL, 0, 0, NULL, 0 };
+    int *header = NULL;        // [bytes, flags] de cada processo
+    int *send_counts = NULL;
+    int *send_displs = NULL;
+    if (world_rank == 0) {
+        total_words = count_table_create(WORD_TABLE_INITIAL_KEYS);
+        total_artists = count_table_create(ARTIST_TABLE_INITIAL_KEYS);
+        batch.capacity = 4 * STREAM_READ_SIZE;
+        batch.data = malloc(batch.capacity);
+        batch.ends = malloc(max_lines * sizeof(size_t));
+        header = malloc(2 * world_size * sizeof(int));
+        send_counts = malloc(world_size * sizeof(int));
+        send_displs = malloc(world_size * sizeof(int));
+    }
+    size_t recv_capacity = STREAM_READ_SIZE;
+    char *recv_buffer = malloc(recv_capacity);
+
+    double start = MPI_Wtime();
+    double next_snapshot = start + config->snapshot_interval;
+    double last_data = start;
+    int header_checked = 0;
+    int finished = 0;
+
+    while (!finished) {
+        int mine[2];
+        if (world_rank == 0) {
+            // 1. Junta linhas até encher o lote, vencer o prazo de envio ou chegar a hora do snapshot
+            rank_stats_enter(STAT_IO);
+            batch.used = 0;
+            batch.count = 0;
+            double deadline = MPI_Wtime() + STREAM_FLUSH_SECONDS;
+            if (deadline > next_snapshot) deadline = next_snapshot;
+            int at_end = 0;
+            while (batch.count < max_lines) {
+                const char *line;
+                size_t len;
+                int status = reader_next(reader, &line, &len, deadline);
+                if (status < 0) {
+                    at_end = 1;
+                    break;
+                }
+                if (status == 0) {
+                    if (config->idle_seconds > 0.0 && MPI_Wtime() - last_data >= config->idle_seconds) at_end = 1;
+                    break;
+                }
+                last_data = MPI_Wtime();
+                if (!header_checked) {
+                    header_checked = 1;
+                    if (len == strlen(STREAM_HEADER) && memcmp(line, STREAM_HEADER, len) == 0) continue;
+                }
+                if (len > 0) batch_add(&batch, line, len, max_lines);
+            }
+
+            // 2. Divide as linhas em faixas contíguas com o mesmo número de linhas
+            int flags = 0;
+            if (at_end) flags |= FLAG_FINISHED | FLAG_SNAPSHOT;
+            if (MPI_Wtime() >= next_snapshot) flags |= FLAG_SNAPSHOT;
+            size_t previous_end = 0;
+            for (int proc = 0; proc < world_size; proc++) {
+                int last_line = (int)((long long)batch.count * (proc + 1) / world_size);
+                size_t end = last_line > 0 ? batch.ends[last_line - 1] : 0;
+                send_displs[proc] = (int)previous_end;
+                send_counts[proc] = (int)(end - previous_end);
+                header[2 * proc] = send_counts[proc];
+                header[2 * proc + 1] = flags;
+                previous_end = end;
+            }
+        }
+
+        // 3. Cada processo recebe o tamanho da sua faixa, os avisos do lote e as linhas
+        rank_stats_enter(STAT_COMM);
+        MPI_Scatter(header, 2, MPI_INT, mine, 2, MPI_INT, 0, MPI_COMM_WORLD);
+        if ((size_t)mine[0] > recv_capacity) {
+            while ((size_t)mine[0] > recv_capacity) recv_capacity *= 2;
+            recv_buffer = realloc(recv_buffer, recv_capacity);
+        }
+        MPI_Scatterv(batch.data, send_counts, send_displs, MPI_BYTE,
+                     recv_buffer, mine[0], MPI_BYTE, 0, MPI_COMM_WORLD);
+        if (world_rank == 0) rank_stats_add(STAT_BYTES_SENT, (long long)batch.used - send_counts[0]);
+
+        // 4. Analisa as músicas da faixa recebida
+        rank_stats_enter(STAT_TOKENIZE);
+        Analyzer analyzers[] = { word_counter_analyzer(words), artist_counter_analyzer(artists) };
+        const char *p = recv_buffer;
+        const char *end = recv_buffer + mine[0];
+        while (p < end) {
+            const char *newline = memchr(p, '\n', end - p);
+            size_t len = newline ? (size_t)(newline - p) : (size_t)(end - p);
+            SongView view;
+            if (song_view_parse(p, len, &view) == 0) {
+                for (int a = 0; a < 2; a++) {
+                    analyzers[a].process_song(analyzers[a].state, &view, (int)delta_songs);
+                }
+                delta_songs++;
+            }
+            p += len + 1;
+        }
+        if (mine[0] > 0) rank_stats_add(STAT_CHUNKS, 1);
+        finished = (mine[1] & FLAG_FINISHED) != 0;
+        if (!(mine[1] & FLAG_SNAPSHOT)) continue;
+
+        // 5. Snapshot: só os deltas trafegam; o processo 0 soma no total acumulado
+        rank_stats_add(STAT_RECORDS, delta_songs);
+        rank_stats_add(STAT_TOKENS, word_counter_tokens(words));
+        rank_stats_add(STAT_WORD_KEYS, word_counter_keys(words));      // Chaves distintas de cada intervalo
+        rank_stats_add(STAT_ARTIST_KEYS, artist_counter_keys(artists));
+        rank_stats_enter(STAT_COMM);
+        long long new_songs = 0;
+        MPI_Reduce(&delta_songs, &new_songs, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+        count_exchange_gather(words->table, 0, MPI_COMM_WORLD);
+        count_exchange_gather(artists->table, 0, MPI_COMM_WORLD);
+        rank_stats_enter(STAT_MERGE);
+        if (world_rank == 0) {
+            count_table_merge(total_words, words->table);
+            count_table_merge(total_artists, artists->table);
+            total_songs += new_songs;
+        }
+        word_counter_free(words);
+        artist_counter_free(artists);
+        words = word_counter_create(0);
+        artists = artist_counter_create(0);
+        delta_songs = 0;
+
+        rank_stats_enter(STAT_OTHER);
+        if (world_rank == 0) {
+            double now = MPI_Wtime();
+            double elapsed = now - start;
+            while (next_snapshot <= now) next_snapshot += config->snapshot_interval;
+            // Intervalos sem músicas novas não geram snapshot (apenas o último sempre sai)
+            if (new_songs > 0 || finished) {
+                snapshot_number++;
+                printf("\n[snapshot %d] %.1f s: %lld songs (%.0f songs/s), %zu unique words, %zu unique artists\n",
+                       snapshot_number, elapsed, total_songs, elapsed > 0.0 ? total_songs / elapsed : 0.0,
+                       total_words->size, total_artists->size);
+                print_top_line("Top words", total_words);
+                print_top_line("Top artists", total_artists);
+                fflush(stdout);
+                if (config->snapshot_path &&
+                    write_snapshot_json(config->snapshot_path, snapshot_number, finished, elapsed, total_songs,
+                                        total_words, total_artists) != 0) {
+                    printf("Aviso: não foi possível gravar o snapshot em %s\n", config->snapshot_path);
+                }
+            }
+            if (finished) print_final(total_words, total_artists, total_songs, elapsed);
+        }
+    }
+
+    reader_close(reader);
+    word_counter_free(words);
+    artist_counter_free(artists);
+    count_table_free(total_words);
+    count_table_free(total_artists);
+    free(batch.data);
+    free(batch.ends);
+    free(header);
+    free(send_counts);
+    free(send_displs);
+    free(recv_buffer);
+    return total_songs;
+}
@@ -0,0 +1,37 @@
+#ifndef SONG_STREAM_H
+#define SONG_STREAM_H
+
+// Inclusão das bibliotecas necessárias
+#include <mpi.h>   // Para distribuir os lotes entre os processos
+
+#define STREAM_BATCH_LINES 512        // Linhas por processo em cada lote
+#define STREAM_FLUSH_SECONDS 0.25     // Espera máxima para completar um lote antes de enviá-lo
+#define STREAM_DEFAULT_INTERVAL 5.0   // Intervalo padrão entre snapshots (segundos)
+
+// Configuração do modo contínuo (--stream)
+typedef struct {
+    const char *source;         // Entrada: "-" = entrada padrão, ou caminho de um pipe/arquivo
+    int follow;                 // 1 = no fim de um arquivo comum, espera novas linhas (como tail -f)
+    double idle_seconds;        // Encerra após esse tempo sem linhas novas (0 = nunca)
+    double snapshot_interval;   // Segundos entre snapshots do top-K
+    const char *snapshot_path;  // JSON reescrito a cada snapshot (NULL = só imprime)
+} StreamConfig;
+
+// Declarações das funções
+
+/**
+ * Executa o modo contínuo: o processo 0 lê linhas "artista|música|letra" da entrada
+ * (um cabeçalho igual ao do CSV é ignorado), forma lotes de até STREAM_BATCH_LINES
+ * linhas por processo e os distribui com MPI_Scatterv; cada processo conta palavras e
+ * artistas do seu pedaço. A cada intervalo só as contagens novas (deltas) são enviadas
+ * ao processo 0, que as soma no total acumulado e imprime/exporta o top-K. No fim da
+ * entrada é feito um último snapshot com os resultados finais. Operação coletiva.
+ * @param config Configuração do modo contínuo
+ * @param world_rank ID do processo atual
+ * @param world_size Número total de processos
+ * @return Número de músicas analisadas (no processo 0; 0 nos demais), ou -1 se a
+ *         entrada não pôde ser aberta
+ */
+long long song_stream_run(const StreamConfig *config, int world_rank, int world_size);
+
+#endif // SONG_STREAM_H
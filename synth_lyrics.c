@@ -0,0 +1,197 @@
+// Gerador de CSV sintético "artista|música|letra" para os benchmarks: vocabulário de
+// tamanho controlado, frequência das palavras com distribuição de Zipf e tamanho das
+// letras com distribuição log-normal. A mesma semente gera sempre o mesmo arquivo.
+#include <stdio.h>    // Para entrada e saída padrão
+#include <stdlib.h>   // Para funções de alocação de memória
+#include <string.h>   // Para strcmp
+#include <stdint.h>   // Para inteiros de tamanho fixo
+#include <math.h>     // Para pow, log, sqrt e exp
+
+#define SYNTH_WRITE_BUFFER (4 * 1024 * 1024)  // Buffer de escrita do CSV
+#define SYNTH_WORDS_PER_LINE 12                // Palavras por verso (quebras viram espaço, como no golden_music.csv)
+
+// Parâmetros do gerador (linha de comando)
+typedef struct {
+    long songs;           // Número de músicas
+    int vocabulary;       // Palavras distintas
+    double zipf;          // Expoente de Zipf das palavras (0 = uniforme)
+    int artists;          // Artistas distintos
+    double artist_zipf;   // Expoente de Zipf dos artistas
+    double mean_words;    // Média de palavras por letra
+    double length_sigma;  // Desvio do log do tamanho (0 = tamanho fixo)
+    uint64_t seed;        // Semente do gerador pseudoaleatório
+    const char *output;   // Arquivo de saída (NULL = saída padrão)
+} SynthOptions;
+
+// xorshift64*: rápido e reproduzível em qualquer plataforma (rand() não é)
+static uint64_t next_random(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+// Número uniforme em [0, 1)
+static double next_uniform(uint64_t *state) {
+    return (next_random(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Distribuição acumulada de Zipf: P(k) proporcional a 1 / (k + 1)^s
+static double* zipf_cdf(int n, double s) {
+    double *cdf = malloc(n * sizeof(double));
+    double total = 0.0;
+    for (int k = 0; k < n; k++) {
+        total += 1.0 / pow(k + 1, s);
+        cdf[k] = total;
+    }
+    for (int k = 0; k < n; k++) {
+        cdf[k] /= total;
+    }
+    return cdf;
+}
+
+// Sorteia uma posição pela distribuição acumulada (busca binária)
+static int zipf_sample(const double *cdf, int n, uint64_t *state) {
+    double u = next_uniform(state);
+    int lo = 0, hi = n - 1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (cdf[mid] < u) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Escreve a palavra de posição k: numeração bijetiva em base 26 a partir de "aa",
+// então todas são distintas e as mais frequentes são as mais curtas
+static int word_text(long k, char *out) {
+    char reversed[16];
+    int len = 0;
+    for (long n = k + 27; n > 0; n = (n - 1) / 26) {
+        reversed[len++] = 'a' + (n - 1) % 26;
+    }
+    for (int i = 0; i < len; i++) {
+        out[i] = reversed[len - 1 - i];
+    }
+    out[len] = '\0';
+    return len;
+}
+
+// Tamanho da letra: log-normal com a média pedida (mínimo de 1 palavra)
+static int lyric_length(const SynthOptions *options, uint64_t *state) {
+    if (options->length_sigma <= 0.0) {
+        return options->mean_words > 1.0 ? (int)options->mean_words : 1;
+    }
+    // Box-Muller; mu é ajustado para que a média de exp(N(mu, sigma)) seja mean_words
+    double u1 = next_uniform(state);
+    double u2 = next_uniform(state);
+    double normal = sqrt(-2.0 * log(1.0 - u1)) * cos(2.0 * M_PI * u2);
+    double mu = log(options->mean_words) - options->length_sigma * options->length_sigma / 2.0;
+    double words = exp(mu + options->length_sigma * normal);
+    return words < 1.0 ? 1 : (int)words;
+}
+
+static void print_usage(const char *program) {
+    printf("Uso: %s [--songs N] [--vocab N] [--zipf S] [--artists N] [--artist-zipf S]\n"
+           "          [--mean-words N] [--length-sigma S] [--seed N] [-o ARQUIVO]\n", program);
+}
+
+// Lê as opções; devolve -1 se alguma for inválida
+static int parse_options(int argc, char *argv[], SynthOptions *options) {
+    options->songs = 10000;
+    options->vocabulary = 50000;
+    options->zipf = 1.1;
+    options->artists = 1000;
+    options->artist_zipf = 0.8;
+    options->mean_words = 220.0;
+    options->length_sigma = 0.5;
+    options->seed = 42;
+    options->output = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!value) return -1;
+        if (strcmp(argv[i], "--songs") == 0) options->songs = atol(value);
+        else if (strcmp(argv[i], "--vocab") == 0) options->vocabulary = atoi(value);
+        else if (strcmp(argv[i], "--zipf") == 0) options->zipf = atof(value);
+        else if (strcmp(argv[i], "--artists") == 0) options->artists = atoi(value);
+        else if (strcmp(argv[i], "--artist-zipf") == 0) options->artist_zipf = atof(value);
+        else if (strcmp(argv[i], "--mean-words") == 0) options->mean_words = atof(value);
+        else if (strcmp(argv[i], "--length-sigma") == 0) options->length_sigma = atof(value);
+        else if (strcmp(argv[i], "--seed") == 0) options->seed = strtoull(value, NULL, 10);
+        else if (strcmp(argv[i], "-o") == 0) options->output = value;
+        else return -1;
+        i++;
+    }
+    if (options->songs < 0 || options->vocabulary < 1 || options->artists < 1 ||
+        options->mean_words < 1.0 || options->zipf < 0.0 || options->artist_zipf < 0.0) {
+        return -1;
+    }
+    if (options->seed == 0) options->seed = 1;  // xorshift não sai do zero
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    SynthOptions options;
+    if (parse_options(argc, argv, &options) != 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    FILE *file = options.output ? fopen(options.output, "w") : stdout;
+    if (!file) {
+        printf("Erro: não foi possível criar %s\n", options.output);
+        return 1;
+    }
+    char *buffer = malloc(SYNTH_WRITE_BUFFER);
+    setvbuf(file, buffer, _IOFBF, SYNTH_WRITE_BUFFER);
+
+    // Textos das palavras gerados uma vez; o sorteio só escolhe a posição
+    char (*words)[16] = malloc((size_t)options.vocabulary * sizeof(*words));
+    for (int k = 0; k < options.vocabulary; k++) {
+        word_text(k, words[k]);
+    }
+    double *word_cdf = zipf_cdf(options.vocabulary, options.zipf);
+    double *artist_cdf = zipf_cdf(options.artists, options.artist_zipf);
+    uint64_t state = options.seed;
+
+    fprintf(file, "artist|song|text\n");
+    long total_words = 0;
+    for (long song = 0; song < options.songs; song++) {
+        char artist[16];
+        word_text(zipf_sample(artist_cdf, options.artists, &state), artist);
+        artist[0] -= 'a' - 'A';
+        fprintf(file, "Artist %s|Song %ld|", artist, song);
+
+        int length = lyric_length(&options, &state);
+        for (int w = 0; w < length; w++) {
+            const char *word = words[zipf_sample(word_cdf, options.vocabulary, &state)];
+            if (w > 0) fputc(' ', file);
+            // Primeira palavra de cada verso em maiúscula, como nas letras reais
+            if (w % SYNTH_WORDS_PER_LINE == 0) {
+                fputc(word[0] - ('a' - 'A'), file);
+                fputs(word + 1, file);
+            } else {
+                fputs(word, file);
+            }
+        }
+        fputc('\n', file);
+        total_words += length;
+    }
+
+    int status = 0;
+    if (options.output) {
+        if (fclose(file) != 0) status = 1;
+        fprintf(stderr, "%s: %ld músicas, %ld palavras (vocabulário %d, zipf %.2f)\n",
+                options.output, options.songs, total_words, options.vocabulary, options.zipf);
+    } else if (fflush(file) != 0) {
+        status = 1;
+    }
+    free(buffer);
+    free(words);
+    free(word_cdf);
+    free(artist_cdf);
+    return status;
+}
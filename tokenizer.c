@@ -0,0 +1,202 @@
+#include "tokenizer.h"
+#include <stdint.h>      // Para uint32_t
+#include <string.h>      // Para memcpy
+#include <ctype.h>       // Para isalpha (implementação escalar)
+#include <immintrin.h>   // Para as instruções SSE4.2 e AVX2
+
+#define TOKENIZER_BLOCK 32       // Bytes classificados por iteração
+#define TOKENIZER_WORD_BUFFER 64 // Buffer da palavra (múltiplo dos vetores, cabe TOKENIZER_MAX_WORD)
+
+typedef void (*TokenizeFunction)(const char *text, size_t len, TokenizerCallback callback, void *context);
+
+// Implementação escalar: o laço original, byte a byte
+static void tokenize_scalar(const char *text, size_t len, TokenizerCallback callback, void *context) {
+    const char *word_start = text;
+    const char *text_end = text + len;
+
+    while (word_start < text_end) {
+        // Skip non-alphabetic characters
+        while (word_start < text_end && !isalpha((unsigned char)*word_start)) {
+            word_start++;
+        }
+
+        if (word_start >= text_end) break;
+
+        const char *word_end = word_start;
+        while (word_end < text_end && isalpha((unsigned char)*word_end)) {
+            word_end++;
+        }
+
+        int word_len = word_end - word_start;
+        if (word_len >= TOKENIZER_MIN_WORD && word_len <= TOKENIZER_MAX_WORD) {
+            char word[TOKENIZER_WORD_BUFFER];
+            for (int j = 0; j < word_len; j++) {
+                char c = word_start[j];
+                word[j] = (c >= 'A' && c <= 'Z') ? (c - 'A' + 'a') : c;
+            }
+            callback(context, word, word_len);
+        }
+
+        word_start = word_end;
+    }
+}
+
+// Laço comum às versões vetoriais: letter_mask classifica 32 bytes em um bit por byte
+// (1 = letra) e lowercase converte o buffer da palavra. Os pontos em que a máscara muda
+// de valor (mask ^ (mask << 1)) são inícios e fins de palavra, visitados com ctz.
+static inline __attribute__((always_inline))
+void tokenize_blocks(const char *text, size_t len, TokenizerCallback callback, void *context,
+                     uint32_t (*letter_mask)(const char *block), void (*lowercase)(char *word, int len)) {
+    uint32_t in_word = 0;    // 1 se a palavra continua do bloco anterior
+    size_t word_start = 0;
+    size_t base = 0;
+    char tail[TOKENIZER_BLOCK];
+
+    while (base < len) {
+        uint32_t letters;
+        if (base + TOKENIZER_BLOCK <= len) {
+            letters = letter_mask(text + base);
+        } else {
+            // Último bloco incompleto: completa com zeros (não letras) sem ler além do texto
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, text + base, len - base);
+            letters = letter_mask(tail);
+        }
+
+        uint32_t edges = letters ^ ((letters << 1) | in_word);
+        while (edges) {
+            int bit = __builtin_ctz(edges);
+            edges &= edges - 1;
+            if (letters & (1u << bit)) {
+                word_start = base + bit;
+                continue;
+            }
+
+            // Fim de palavra: aplica o filtro de tamanho e entrega em minúsculas
+            size_t word_len = base + bit - word_start;
+            if (word_len >= TOKENIZER_MIN_WORD && word_len <= TOKENIZER_MAX_WORD) {
+                char word[TOKENIZER_WORD_BUFFER];
+                memcpy(word, text + word_start, word_len);
+                lowercase(word, (int)word_len);
+                callback(context, word, (int)word_len);
+            }
+        }
+        in_word = letters >> 31;
+        base += TOKENIZER_BLOCK;
+    }
+
+    // Texto terminado no meio de uma palavra (só acontece sem bloco final incompleto)
+    if (in_word) {
+        size_t word_len = len - word_start;
+        if (word_len >= TOKENIZER_MIN_WORD && word_len <= TOKENIZER_MAX_WORD) {
+            char word[TOKENIZER_WORD_BUFFER];
+            memcpy(word, text + word_start, word_len);
+            lowercase(word, (int)word_len);
+            callback(context, word, (int)word_len);
+        }
+    }
+}
+
+// SSE4.2: PCMPESTRM com as faixas "AZaz" marca as letras de 16 bytes por instrução
+__attribute__((target("sse4.2")))
+static uint32_t letter_mask_sse42(const char *block) {
+    const __m128i ranges = _mm_setr_epi8('A', 'Z', 'a', 'z', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    __m128i low = _mm_loadu_si128((const __m128i *)block);
+    __m128i high = _mm_loadu_si128((const __m128i *)(block + 16));
+    const int mode = _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_BIT_MASK;
+    uint32_t low_mask = (uint32_t)_mm_cvtsi128_si32(_mm_cmpestrm(ranges, 4, low, 16, mode));
+    uint32_t high_mask = (uint32_t)_mm_cvtsi128_si32(_mm_cmpestrm(ranges, 4, high, 16, mode));
+    return (low_mask & 0xffff) | (high_mask << 16);
+}
+
+// SSE4.2: soma 0x20 aos bytes entre 'A' e 'Z', 16 por vez (o buffer tem folga até 64 bytes)
+__attribute__((target("sse4.2")))
+static void lowercase_sse42(char *word, int len) {
+    const __m128i before_a = _mm_set1_epi8('A' - 1);
+    const __m128i after_z = _mm_set1_epi8('Z' + 1);
+    const __m128i flip = _mm_set1_epi8(0x20);
+    for (int i = 0; i < len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(word + i));
+        __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, before_a), _mm_cmpgt_epi8(after_z, v));
+        _mm_storeu_si128((__m128i *)(word + i), _mm_or_si128(v, _mm_and_si128(upper, flip)));
+    }
+}
+
+__attribute__((target("sse4.2")))
+static void tokenize_sse42(const char *text, size_t len, TokenizerCallback callback, void *context) {
+    tokenize_blocks(text, len, callback, context, letter_mask_sse42, lowercase_sse42);
+}
+
+// AVX2: (byte | 0x20) entre 'a' e 'z' identifica as letras; bytes >= 0x80 são negativos
+// na comparação com sinal e ficam de fora
+__attribute__((target("avx2")))
+static uint32_t letter_mask_avx2(const char *block) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)block);
+    __m256i folded = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    __m256i ge_a = _mm256_cmpgt_epi8(folded, _mm256_set1_epi8('a' - 1));
+    __m256i le_z = _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), folded);
+    return (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(ge_a, le_z));
+}
+
+// AVX2: soma 0x20 aos bytes entre 'A' e 'Z', 32 por vez
+__attribute__((target("avx2")))
+static void lowercase_avx2(char *word, int len) {
+    const __m256i before_a = _mm256_set1_epi8('A' - 1);
+    const __m256i after_z = _mm256_set1_epi8('Z' + 1);
+    const __m256i flip = _mm256_set1_epi8(0x20);
+    for (int i = 0; i < len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(word + i));
+        __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, before_a), _mm256_cmpgt_epi8(after_z, v));
+        _mm256_storeu_si256((__m256i *)(word + i), _mm256_or_si256(v, _mm256_and_si256(upper, flip)));
+    }
+}
+
+__attribute__((target("avx2")))
+static void tokenize_avx2(const char *text, size_t len, TokenizerCallback callback, void *context) {
+    tokenize_blocks(text, len, callback, context, letter_mask_avx2, lowercase_avx2);
+}
+
+static void tokenize_dispatch(const char *text, size_t len, TokenizerCallback callback, void *context);
+
+// Implementação ativa; a primeira chamada passa pela detecção da CPU
+static TokenizeFunction active_tokenizer = tokenize_dispatch;
+
+// Escolhe a implementação (a detecção usa __builtin_cpu_supports)
+TokenizerKernel tokenizer_select(TokenizerKernel kernel) {
+    __builtin_cpu_init();
+    int has_avx2 = __builtin_cpu_supports("avx2");
+    int has_sse42 = __builtin_cpu_supports("sse4.2");
+
+    if (kernel == TOKENIZER_AUTO) {
+        kernel = has_avx2 ? TOKENIZER_AVX2 : has_sse42 ? TOKENIZER_SSE42 : TOKENIZER_SCALAR;
+    }
+    if (kernel == TOKENIZER_AVX2 && !has_avx2) kernel = has_sse42 ? TOKENIZER_SSE42 : TOKENIZER_SCALAR;
+    if (kernel == TOKENIZER_SSE42 && !has_sse42) kernel = TOKENIZER_SCALAR;
+
+    TokenizeFunction function = (kernel == TOKENIZER_AVX2) ? tokenize_avx2 :
+                                (kernel == TOKENIZER_SSE42) ? tokenize_sse42 : tokenize_scalar;
+    __atomic_store_n(&active_tokenizer, function, __ATOMIC_RELEASE);
+    return kernel;
+}
+
+// Primeira chamada: detecta a CPU e repassa para a implementação escolhida
+static void tokenize_dispatch(const char *text, size_t len, TokenizerCallback callback, void *context) {
+    tokenizer_select(TOKENIZER_AUTO);
+    tokenize_words(text, len, callback, context);
+}
+
+// Separa as palavras do texto com a implementação ativa
+void tokenize_words(const char *text, size_t len, TokenizerCallback callback, void *context) {
+    TokenizeFunction function = __atomic_load_n(&active_tokenizer, __ATOMIC_ACQUIRE);
+    function(text, len, callback, context);
+}
+
+// Nome de uma implementação
+const char* tokenizer_kernel_name(TokenizerKernel kernel) {
+    switch (kernel) {
+        case TOKENIZER_SCALAR: return "scalar";
+        case TOKENIZER_SSE42: return "sse4.2";
+        case TOKENIZER_AVX2: return "avx2";
+        default: return "auto";
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+// Inclusão das bibliotecas necessárias
+#include <stddef.h>   // Para size_t
+
+// Filtro de tamanho das palavras (mesmo da contagem original)
+#define TOKENIZER_MIN_WORD 2    // Palavras menores são ignoradas
+#define TOKENIZER_MAX_WORD 50   // Palavras maiores são ignoradas
+
+// Implementações disponíveis do tokenizador
+typedef enum {
+    TOKENIZER_AUTO,    // Escolhe a melhor suportada pela CPU (padrão)
+    TOKENIZER_SCALAR,  // Byte a byte com isalpha (laço original)
+    TOKENIZER_SSE42,   // Blocos de 16 bytes classificados com PCMPESTRM
+    TOKENIZER_AVX2     // Blocos de 32 bytes classificados com comparações AVX2
+} TokenizerKernel;
+
+// Recebe cada palavra aceita, já em minúsculas (o buffer só vale durante a chamada)
+typedef void (*TokenizerCallback)(void *context, const char *word, int len);
+
+// Declarações das funções
+
+/**
+ * Separa as palavras (sequências de letras A-Z/a-z) de um texto, converte para
+ * minúsculas e entrega as que têm entre TOKENIZER_MIN_WORD e TOKENIZER_MAX_WORD letras
+ * @param text Início do texto (não precisa terminar em '\0')
+ * @param len Tamanho do texto
+ * @param callback Função chamada para cada palavra
+ * @param context Ponteiro repassado ao callback
+ */
+void tokenize_words(const char *text, size_t len, TokenizerCallback callback, void *context);
+
+/**
+ * Força uma implementação (usado pelo micro-benchmark); TOKENIZER_AUTO volta à detecção
+ * @param kernel Implementação desejada
+ * @return A implementação efetivamente ativada (a CPU pode não suportar a pedida)
+ */
+TokenizerKernel tokenizer_select(TokenizerKernel kernel);
+
+/**
+ * Nome de uma implementação, para os logs
+ * @param kernel Implementação
+ * @return Nome legível ("scalar", "sse4.2" ou "avx2")
+ */
+const char* tokenizer_kernel_name(TokenizerKernel kernel);
+
+#endif // TOKENIZER_H
@@ -0,0 +1,106 @@
+// Micro-benchmark do tokenizador: compara as implementações escalar, SSE4.2 e AVX2
+// sobre as letras do CSV e confere se todas encontram as mesmas palavras
+#include <stdio.h>    // Para entrada e saída padrão
+#include <stdlib.h>   // Para funções de alocação de memória
+#include <string.h>   // Para memchr
+#include <time.h>     // Para clock_gettime
+#include "tokenizer.h"
+
+#define BENCH_REPETITIONS 20  // Passadas sobre o arquivo por implementação
+
+// Resumo das palavras vistas: contagem e uma soma simples para comparar implementações
+typedef struct {
+    unsigned long long words;
+    unsigned long long checksum;
+} BenchTotals;
+
+// Conferência: soma todos os bytes de cada palavra
+static void check_word(void *context, const char *word, int len) {
+    BenchTotals *totals = (BenchTotals*)context;
+    totals->words++;
+    for (int i = 0; i < len; i++) {
+        totals->checksum = totals->checksum * 31 + (unsigned char)word[i];
+    }
+}
+
+// Medição: trabalho mínimo por palavra, para o tempo ser do tokenizador
+static void count_word(void *context, const char *word, int len) {
+    BenchTotals *totals = (BenchTotals*)context;
+    totals->words++;
+    totals->checksum += (unsigned char)word[0] + len;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Tokeniza a letra (terceiro campo) de cada linha, como na contagem de palavras
+static void tokenize_file(const char *data, size_t size, TokenizerCallback callback, BenchTotals *totals) {
+    const char *p = data;
+    const char *end = data + size;
+    while (p < end) {
+        const char *newline = memchr(p, '\n', end - p);
+        const char *line_end = newline ? newline : end;
+        const char *song = memchr(p, '|', line_end - p);
+        const char *text = song ? memchr(song + 1, '|', line_end - song - 1) : NULL;
+        if (text) {
+            tokenize_words(text + 1, line_end - text - 1, callback, totals);
+        }
+        p = line_end + 1;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const char *filename = (argc > 1) ? argv[1] : "test_music.csv";
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        printf("Erro: não foi possível abrir %s\n", filename);
+        return 1;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *data = malloc(size > 0 ? size : 1);
+    size_t read_size = fread(data, 1, size, file);
+    fclose(file);
+
+    printf("Tokenizador: %s (%.1f MB, %d passadas)\n", filename, read_size / 1e6, BENCH_REPETITIONS);
+
+    TokenizerKernel kernels[] = { TOKENIZER_SCALAR, TOKENIZER_SSE42, TOKENIZER_AVX2 };
+    double scalar_rate = 0.0;
+    BenchTotals reference = { 0, 0 };
+    int status = 0;
+
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        TokenizerKernel active = tokenizer_select(kernels[k]);
+        if (active != kernels[k]) {
+            printf("  %-7s não suportado pela CPU\n", tokenizer_kernel_name(kernels[k]));
+            continue;
+        }
+
+        BenchTotals totals = { 0, 0 };
+        tokenize_file(data, read_size, check_word, &totals);  // Aquecimento e conferência
+        double start = now_seconds();
+        for (int r = 0; r < BENCH_REPETITIONS; r++) {
+            BenchTotals pass = { 0, 0 };
+            tokenize_file(data, read_size, count_word, &pass);
+        }
+        double elapsed = now_seconds() - start;
+        double rate = read_size * (double)BENCH_REPETITIONS / elapsed / 1e6;
+
+        if (k == 0) {
+            reference = totals;
+            scalar_rate = rate;
+        } else if (totals.words != reference.words || totals.checksum != reference.checksum) {
+            printf("  %-7s ERRO: palavras diferentes da versão escalar\n", tokenizer_kernel_name(active));
+            status = 1;
+        }
+        printf("  %-7s %8.1f MB/s  %5.2fx  (%llu palavras)\n", tokenizer_kernel_name(active), rate,
+               scalar_rate > 0.0 ? rate / scalar_rate : 1.0, totals.words);
+    }
+
+    free(data);
+    return status;
+}
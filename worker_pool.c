@@ -0,0 +1,119 @@
+#include "worker_pool.h"
+#include <stdlib.h>    // Para funções de alocação de memória
+
+// Laço de uma thread: espera um pedaço, processa blocos de músicas e avisa ao terminar
+static void* worker_main(void *arg) {
+    WorkerThread *worker = (WorkerThread*)arg;
+    WorkerPool *pool = worker->pool;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (pool->generation == seen && !pool->stop) {
+            pthread_cond_wait(&pool->work_ready, &pool->mutex);
+        }
+        if (pool->generation == seen) break;  // Encerramento sem pedaço pendente
+        seen = pool->generation;
+        const SongView *songs = pool->songs;
+        int count = pool->count;
+        int start_line = pool->start_line;
+        pthread_mutex_unlock(&pool->mutex);
+
+        // Blocos pequenos retirados sob demanda: letras longas não atrasam uma única thread
+        int first;
+        while ((first = __atomic_fetch_add(&pool->next_song, WORKER_POOL_BLOCK, __ATOMIC_RELAXED)) < count) {
+            int last = (first + WORKER_POOL_BLOCK < count) ? first + WORKER_POOL_BLOCK : count;
+            for (int i = first; i < last; i++) {
+                for (int a = 0; a < pool->num_analyzers; a++) {
+                    worker->analyzers[a].process_song(worker->analyzers[a].state, &songs[i], start_line + i);
+                }
+            }
+        }
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->pending == 0) {
+            pthread_cond_signal(&pool->work_done);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+// Cria o pool com estados locais para cada thread
+WorkerPool* worker_pool_create(int num_threads, Analyzer *analyzers, int num_analyzers) {
+    WorkerPool *pool = malloc(sizeof(WorkerPool));
+    pool->num_threads = num_threads;
+    pool->analyzers = analyzers;
+    pool->num_analyzers = num_analyzers;
+    pool->songs = NULL;
+    pool->count = 0;
+    pool->start_line = 0;
+    pool->next_song = 0;
+    pool->generation = 0;
+    pool->pending = 0;
+    pool->stop = 0;
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->work_ready, NULL);
+    pthread_cond_init(&pool->work_done, NULL);
+
+    pool->threads = malloc(num_threads * sizeof(pthread_t));
+    pool->workers = malloc(num_threads * sizeof(WorkerThread));
+    for (int t = 0; t < num_threads; t++) {
+        WorkerThread *worker = &pool->workers[t];
+        worker->pool = pool;
+        worker->analyzers = malloc(num_analyzers * sizeof(Analyzer));
+        for (int a = 0; a < num_analyzers; a++) {
+            worker->analyzers[a] = analyzers[a];
+            worker->analyzers[a].state = analyzers[a].clone_state(analyzers[a].state);
+        }
+        pthread_create(&pool->threads[t], NULL, worker_main, worker);
+    }
+    return pool;
+}
+
+// Entrega um pedaço às threads
+void worker_pool_submit(WorkerPool *pool, const SongView *songs, int count, int start_line) {
+    pthread_mutex_lock(&pool->mutex);
+    pool->songs = songs;
+    pool->count = count;
+    pool->start_line = start_line;
+    pool->next_song = 0;
+    pool->pending = pool->num_threads;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+// Espera as threads terminarem o pedaço entregue
+void worker_pool_wait(WorkerPool *pool) {
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->pending > 0) {
+        pthread_cond_wait(&pool->work_done, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+// Encerra as threads e junta os estados locais nos analisadores principais
+void worker_pool_free(WorkerPool *pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int t = 0; t < pool->num_threads; t++) {
+        pthread_join(pool->threads[t], NULL);
+        for (int a = 0; a < pool->num_analyzers; a++) {
+            pool->analyzers[a].merge_state(pool->analyzers[a].state, pool->workers[t].analyzers[a].state);
+        }
+        free(pool->workers[t].analyzers);
+    }
+
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_cond_destroy(&pool->work_done);
+    free(pool->threads);
+    free(pool->workers);
+    free(pool);
+}
@@ -0,0 +1,70 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+// Inclusão das bibliotecas necessárias
+#include <pthread.h>      // Para as threads de trabalho
+#include "analyzer.h"     // Para Analyzer e SongView
+
+#define WORKER_POOL_BLOCK 8  // Músicas retiradas por vez por cada thread (equilibra letras longas)
+
+struct WorkerPool;
+
+// Estado de uma thread de trabalho: cópias locais dos analisadores
+typedef struct {
+    struct WorkerPool *pool;  // Pool ao qual a thread pertence
+    Analyzer *analyzers;      // Analisadores com estado local desta thread
+} WorkerThread;
+
+// Pool de threads que aplica os analisadores às músicas de um pedaço. As threads
+// não chamam MPI (MPI_THREAD_FUNNELED): só a thread principal lê e comunica.
+typedef struct WorkerPool {
+    int num_threads;              // Número de threads de trabalho
+    pthread_t *threads;           // Identificadores das threads
+    WorkerThread *workers;        // Estado de cada thread
+    Analyzer *analyzers;          // Analisadores principais (recebem os estados locais no fim)
+    int num_analyzers;            // Número de analisadores
+    pthread_mutex_t mutex;        // Protege os campos abaixo
+    pthread_cond_t work_ready;    // Sinaliza um novo pedaço (ou o encerramento)
+    pthread_cond_t work_done;     // Sinaliza que todas as threads terminaram o pedaço
+    const SongView *songs;        // Pedaço atual
+    int count;                    // Músicas no pedaço atual
+    int start_line;               // Índice global da primeira música do pedaço
+    int next_song;                // Próxima música livre (retirada atomicamente em blocos)
+    unsigned long generation;     // Número do pedaço atual
+    int pending;                  // Threads que ainda não terminaram o pedaço atual
+    int stop;                     // Pede o encerramento das threads
+} WorkerPool;
+
+// Declarações das funções
+
+/**
+ * Cria o pool; cada thread recebe estados vazios próprios (clone_state) dos analisadores
+ * @param num_threads Número de threads de trabalho
+ * @param analyzers Analisadores principais
+ * @param num_analyzers Número de analisadores
+ * @return Ponteiro para WorkerPool alocado
+ */
+WorkerPool* worker_pool_create(int num_threads, Analyzer *analyzers, int num_analyzers);
+
+/**
+ * Entrega um pedaço às threads e retorna imediatamente (o chamador pode ler o próximo)
+ * @param pool Pool de threads
+ * @param songs Músicas do pedaço (devem continuar válidas até worker_pool_wait)
+ * @param count Número de músicas
+ * @param start_line Índice global da primeira música
+ */
+void worker_pool_submit(WorkerPool *pool, const SongView *songs, int count, int start_line);
+
+/**
+ * Espera as threads terminarem o pedaço entregue
+ * @param pool Pool de threads
+ */
+void worker_pool_wait(WorkerPool *pool);
+
+/**
+ * Encerra as threads e soma os estados locais nos analisadores principais (merge_state)
+ * @param pool Ponteiro para WorkerPool a ser liberado
+ */
+void worker_pool_free(WorkerPool *pool);
+
+#endif // WORKER_POOL_H